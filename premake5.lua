@@ -368,6 +368,249 @@ project "wave"
 		}
 		optimize "On"
 		
+	filter "configurations:Dist"
+		defines
+		{
+			"AF_CONF_DIST"
+		}
+		optimize "On"
+
+project "wave-headless"
+	location ("projects/wave")
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	
+	targetdir (bindir)
+	objdir (intdir)
+
+	-- The game without a window, GL or audio, drawing goes to the null renderer
+	files
+	{
+		"projects/wave/src/**.h",
+		"projects/wave/src/**.cpp"
+	}
+
+	removefiles
+	{
+		"projects/wave/src/Audio.cpp",
+		"projects/wave/src/Resources.cpp"
+	}
+	
+	-- glfw, glad and nanovg only for their headers, none of them are linked
+	includedirs
+	{
+		includes["glad"],
+		includes["glfw"],
+		includes["glm"],
+		includes["spdlog"],
+		includes["nanovg"]
+	}
+	
+	defines
+	{
+		"AF_HEADLESS",
+		"GLFW_INCLUDE_NONE",
+		"SPDLOG_WCHAR_TO_UTF8_SUPPORT"
+	}
+		
+	filter "system:windows"
+		staticruntime "On"
+		systemversion "latest"
+		
+		defines
+		{
+			"AF_PLAT_WINDOWS"
+		}
+
+		links
+		{
+			"psapi"
+		}
+
+	filter "system:linux"
+		defines
+		{
+			"AF_PLAT_LINUX"
+		}
+
+		links
+		{
+			"pthread"
+		}
+
+	filter "configurations:Debug"
+		defines
+		{
+			"AF_CONF_DEBUG"
+		}
+		symbols "On"
+
+	filter "configurations:Release"
+		defines
+		{
+			"AF_CONF_RELEASE"
+		}
+		optimize "On"
+		
+	filter "configurations:Dist"
+		defines
+		{
+			"AF_CONF_DIST"
+		}
+		optimize "On"
+
+project "wave-ecs-bench"
+	location (prjroot)
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	
+	targetdir (bindir)
+	objdir (intdir)
+
+	-- Runs headless, only the ECS and the game's components are built in
+	files
+	{
+		prjroot .. "src/**.h",
+		prjroot .. "src/**.cpp",
+
+		"projects/wave/src/ECS.cpp",
+		"projects/wave/src/Pool.cpp",
+		"projects/wave/src/JobSystem.cpp",
+		"projects/wave/src/Scheduler.cpp",
+		"projects/wave/src/CommandBuffer.cpp",
+		"projects/wave/src/Prefabs.cpp",
+		"projects/wave/src/Random.cpp",
+		"projects/wave/src/Log.cpp"
+	}
+	
+	includedirs
+	{
+		"projects/wave/src/",
+		includes["glm"],
+		includes["spdlog"]
+	}
+	
+	defines
+	{
+		"SPDLOG_WCHAR_TO_UTF8_SUPPORT",
+		"AF_COUNT_SYNC"
+	}
+		
+	filter "system:windows"
+		staticruntime "On"
+		systemversion "latest"
+		
+		defines
+		{
+			"AF_PLAT_WINDOWS"
+		}
+
+	filter "system:linux"
+		defines
+		{
+			"AF_PLAT_LINUX"
+		}
+
+		links
+		{
+			"pthread"
+		}
+
+	filter "configurations:Debug"
+		defines
+		{
+			"AF_CONF_DEBUG"
+		}
+		symbols "On"
+
+	filter "configurations:Release"
+		defines
+		{
+			"AF_CONF_RELEASE"
+		}
+		optimize "On"
+		
+	filter "configurations:Dist"
+		defines
+		{
+			"AF_CONF_DIST"
+		}
+		optimize "On"
+
+project "wave-ecs-check"
+	location (prjroot)
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	
+	targetdir (bindir)
+	objdir (intdir)
+
+	-- Behaviour checks for the ECS, exits with a non zero code when one fails
+	files
+	{
+		prjroot .. "src/**.h",
+		prjroot .. "src/**.cpp",
+
+		"projects/wave/src/ECS.cpp",
+		"projects/wave/src/Snapshot.cpp",
+		"projects/wave/src/Pool.cpp",
+		"projects/wave/src/JobSystem.cpp",
+		"projects/wave/src/Scheduler.cpp",
+		"projects/wave/src/CommandBuffer.cpp",
+		"projects/wave/src/Prefabs.cpp",
+		"projects/wave/src/Random.cpp",
+		"projects/wave/src/Log.cpp"
+	}
+	
+	includedirs
+	{
+		"projects/wave/src/",
+		includes["glm"],
+		includes["spdlog"]
+	}
+	
+	defines
+	{
+		"SPDLOG_WCHAR_TO_UTF8_SUPPORT"
+	}
+		
+	filter "system:windows"
+		staticruntime "On"
+		systemversion "latest"
+		
+		defines
+		{
+			"AF_PLAT_WINDOWS"
+		}
+
+	filter "system:linux"
+		defines
+		{
+			"AF_PLAT_LINUX"
+		}
+
+		links
+		{
+			"pthread"
+		}
+
+	filter "configurations:Debug"
+		defines
+		{
+			"AF_CONF_DEBUG"
+		}
+		symbols "On"
+
+	filter "configurations:Release"
+		defines
+		{
+			"AF_CONF_RELEASE"
+		}
+		optimize "On"
+		
 	filter "configurations:Dist"
 		defines
 		{
@@ -0,0 +1,295 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include "ECS.h"
+#include "Scheduler.h"
+#include "Log.h"
+#include "Components.h"
+#include "Prefabs.h"
+
+// Every global allocation is counted so each operation can report allocations alongside its time
+static std::atomic<uint64_t> s_Allocations = 0;
+
+void* operator new(size_t size)
+{
+	++s_Allocations;
+
+	if (void* data = std::malloc(size ? size : 1))
+		return data;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+// Kept out of line, once inlined into a caller GCC pairs the std::free with the replaced operator new
+// and reports -Wmismatched-new-delete
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void* data) noexcept
+{
+	std::free(data);
+}
+
+void operator delete(void* data, size_t) noexcept
+{
+	operator delete(data);
+}
+
+void operator delete[](void* data) noexcept
+{
+	operator delete(data);
+}
+
+void operator delete[](void* data, size_t) noexcept
+{
+	operator delete(data);
+}
+
+glm::vec2 GetWorldSize()
+{
+	return { 1280.0f, 720.0f };
+}
+
+namespace
+{
+	// Written once per run so the measured loops can't be optimised away
+	volatile float s_Sink = 0.0f;
+
+	struct Mix
+	{
+		const char* m_Name;
+		const AF::ECS::Prefab& (*m_Prefab)();
+	};
+
+	// Measures `function` over `operations` operations and prints one JSON object per line.
+	// `counted_sync` only counts the job submissions and waits marked with AF_COUNT_SYNC_OP in the job system.
+	// Other atomics and locks, such as shared_ptr refcounts, logging or the allocator, are not seen, so a zero
+	// only shows that none of the marked points were hit. The per row passes, kills included, are expected to
+	// report zero, DestroyEntity takes no lock as parallel systems kill through their CommandBuffer.
+	template<typename t_Function>
+	void Measure(const char* mix, size_t entities, const char* operation, size_t operations, t_Function&& function)
+	{
+		uint64_t allocations = s_Allocations.load();
+		uint64_t syncOperations = AF::s_SyncOperations.load();
+		auto start = std::chrono::steady_clock::now();
+
+		function();
+
+		auto end = std::chrono::steady_clock::now();
+		allocations = s_Allocations.load() - allocations;
+		syncOperations = AF::s_SyncOperations.load() - syncOperations;
+
+		double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+		size_t count = operations ? operations : 1;
+
+		std::printf("{\"mix\":\"%s\",\"entities\":%zu,\"op\":\"%s\",\"ops\":%zu,\"ns_total\":%.0f,\"ns_per_op\":%.3f,\"allocs\":%llu,\"allocs_per_op\":%.4f,\"counted_sync\":%llu}\n",
+			mix, entities, operation, count, nanoseconds, nanoseconds / count, static_cast<unsigned long long>(allocations), static_cast<double>(allocations) / count,
+			static_cast<unsigned long long>(syncOperations));
+	}
+
+	// Deterministic shuffle so lookups miss the cache the same way on every run
+	void Shuffle(std::vector<AF::ECS::EntityId>& ids)
+	{
+		uint64_t state = 0x9E3779B97F4A7C15ull;
+
+		for (size_t i = ids.size(); i > 1; --i)
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			std::swap(ids[i - 1], ids[(state >> 33) % i]);
+		}
+	}
+
+	// Movement and edge bouncing the way the game's systems do them, through ParallelEach on the job system
+	AF::ECS::Scheduler CreateTickScheduler(AF::JobSystem& jobs)
+	{
+		using namespace AF::ECS;
+
+		Scheduler scheduler;
+
+		scheduler.Add<Read<RigidBody>, Write<Transform>>("Movement", [&jobs](Scene& scene)
+		{
+			scene.ParallelEach<const RigidBody, Transform>(jobs, [](const RigidBody& rigidBody, Transform& transform)
+			{
+				transform.m_PreviousPosition = transform.m_Position;
+				transform.m_Position += rigidBody.m_Velocity * (1.0f / 120.0f);
+			});
+		});
+
+		scheduler.Add<Read<EdgeBouncer>, Write<Transform, RigidBody>>("Edge", [&jobs](Scene& scene)
+		{
+			glm::vec2 bounds = GetWorldSize();
+
+			scene.ParallelEach<const EdgeBouncer, RigidBody, Transform>(jobs, [bounds](const EdgeBouncer&, RigidBody& rigidBody, Transform& transform)
+			{
+				if (transform.m_Position.x < 0.0f || transform.m_Position.x + transform.m_Size.x > bounds.x) rigidBody.m_Velocity.x *= -1.0f;
+				if (transform.m_Position.y < 0.0f || transform.m_Position.y + transform.m_Size.y > bounds.y) rigidBody.m_Velocity.y *= -1.0f;
+			});
+		});
+
+		return scheduler;
+	}
+
+	void RunMix(const Mix& mix, size_t entities, AF::JobSystem& jobs)
+	{
+		AF::ECS::Scene scene;
+		const AF::ECS::Prefab& prefab = mix.m_Prefab();
+
+		// One Instantiate call per entity, the way the game spawns
+		Measure(mix.m_Name, entities, "create_single", entities, [&]()
+		{
+			for (size_t i = 0; i < entities; ++i)
+				scene.Instantiate(prefab);
+		});
+
+		Measure(mix.m_Name, entities, "update_start", entities, [&]()
+		{
+			scene.Update();
+		});
+
+		Measure(mix.m_Name, entities, "clear", entities, [&]()
+		{
+			scene.Clear();
+		});
+
+		Measure(mix.m_Name, entities, "create_batch", entities, [&]()
+		{
+			scene.Instantiate(prefab, entities);
+		});
+
+		scene.Update();
+
+		Measure(mix.m_Name, entities, "update_idle", 1, [&]()
+		{
+			scene.Update();
+		});
+
+		std::vector<AF::ECS::EntityId> ids;
+		ids.reserve(entities);
+
+		scene.Each<const Transform>([&ids](AF::ECS::Entity& entity, const Transform&)
+		{
+			ids.push_back(entity.m_Id);
+		});
+
+		Shuffle(ids);
+
+		float sink = 0.0f;
+
+		Measure(mix.m_Name, entities, "get_component", ids.size(), [&]()
+		{
+			for (AF::ECS::EntityId id : ids)
+				sink += scene.GetComponent<const Transform>(id)->m_Position.x;
+		});
+
+		Measure(mix.m_Name, entities, "each_transform", entities, [&]()
+		{
+			scene.Each<const Transform>([&sink](const Transform& transform)
+			{
+				sink += transform.m_Position.x;
+			});
+		});
+
+		// The shape of MovementSystem, handles and references only
+		Measure(mix.m_Name, entities, "each_integrate", entities, [&]()
+		{
+			scene.Each<const RigidBody, Transform>([](AF::ECS::Entity&, const RigidBody& rigidBody, Transform& transform)
+			{
+				transform.m_Position += rigidBody.m_Velocity * (1.0f / 60.0f);
+			});
+		});
+
+		// Whole ticks the way TickScene runs them. Every thread grows its own scratch list and job queue the first time
+		// it runs a system, the warm up ticks cover most of that. Which thread picks up a system is up to timing, so a
+		// measured tick can still report the few allocations of a thread running one for the first time.
+		// Job submissions and waits show up in counted_sync, they depend on the chunk count and not on the rows.
+		AF::ECS::Scheduler scheduler = CreateTickScheduler(jobs);
+		constexpr size_t ticks = 100;
+
+		for (size_t tick = 0; tick < 20; ++tick)
+		{
+			scene.Update();
+			scheduler.Run(scene, jobs);
+		}
+
+		Measure(mix.m_Name, entities, "tick_scheduled", ticks, [&]()
+		{
+			for (size_t tick = 0; tick < ticks; ++tick)
+			{
+				scene.Update();
+				scheduler.Run(scene, jobs);
+			}
+		});
+
+		Measure(mix.m_Name, entities, "get_component_mut", ids.size(), [&]()
+		{
+			for (AF::ECS::EntityId id : ids)
+				scene.GetComponent<Transform>(id)->m_Position.y += 1.0f;
+		});
+
+		// Kill every other entity in shuffled order, then let Update compact the archetypes
+		size_t killed = ids.size() / 2;
+
+		Measure(mix.m_Name, entities, "kill", killed, [&]()
+		{
+			for (size_t i = 0; i < killed; ++i)
+				scene.DestroyEntity(ids[i]);
+		});
+
+		Measure(mix.m_Name, entities, "flush_killed", killed, [&]()
+		{
+			scene.Update();
+		});
+
+		Measure(mix.m_Name, entities, "destroy_all", scene.m_EntityCount, [&]()
+		{
+			for (size_t i = killed; i < ids.size(); ++i)
+				scene.DestroyEntity(ids[i]);
+
+			scene.Update();
+		});
+
+		s_Sink = sink;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	AF::CreateLogger();
+	AF::s_Logger->set_level(spdlog::level::warn);
+
+	std::vector<size_t> sizes = { 1000, 10000, 100000, 1000000 };
+
+	// An optional argument caps the largest size, eg `wave-ecs-bench 100000`
+	if (argc > 1)
+	{
+		size_t limit = std::strtoull(argv[1], nullptr, 10);
+		while (!sizes.empty() && sizes.back() > limit) sizes.pop_back();
+	}
+
+	std::vector<Mix> mixes =
+	{
+		{ "enemy", GetBasicEnemyPrefab },
+		{ "menu_particle", GetMenuParticlePrefab }
+	};
+
+	AF::JobSystem jobs;
+
+	for (const Mix& mix : mixes)
+	{
+		for (size_t entities : sizes)
+			RunMix(mix, entities, jobs);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <cstdio>
+#include <vector>
+
+#include "ECS.h"
+#include "Snapshot.h"
+#include "Log.h"
+#include "Components.h"
+#include "Prefabs.h"
+
+glm::vec2 GetWorldSize()
+{
+	return { 1280.0f, 720.0f };
+}
+
+namespace
+{
+	struct Check
+	{
+		const char* m_Name;
+		bool (*m_Function)();
+	};
+
+	// A handle taken after a checkpoint must stay dead once the checkpoint is loaded, even after its index is handed out again
+	bool CheckSnapshotHandles()
+	{
+		AF::ECS::Scene scene;
+		const AF::ECS::Prefab& prefab = GetBasicEnemyPrefab();
+
+		AF::ECS::EntityId kept = scene.Instantiate(prefab).m_Id;
+		scene.Update();
+
+		std::vector<std::byte> checkpoint;
+		if (!AF::ECS::SaveSnapshot(scene, checkpoint)) return false;
+
+		// One new index and one reused index, both after the checkpoint
+		AF::ECS::EntityId added = scene.Instantiate(prefab).m_Id;
+		scene.DestroyEntity(kept);
+		scene.Update();
+		AF::ECS::EntityId reused = scene.Instantiate(prefab).m_Id;
+
+		if (!AF::ECS::LoadSnapshot(scene, checkpoint)) return false;
+		if (!scene.IsValid(kept) || scene.IsValid(added) || scene.IsValid(reused)) return false;
+
+		// Frees the index `reused` lives at again, then hands out both indices
+		scene.DestroyEntity(kept);
+		scene.Update();
+		scene.Instantiate(prefab, 2);
+
+		return !scene.IsValid(kept) && !scene.IsValid(added) && !scene.IsValid(reused);
+	}
+
+	// Changed<T> visits a row during the Update it was written in and the one after, then skips it again
+	bool CheckChangedFilter()
+	{
+		// No spawner, so nothing writes the Transform when the entities start
+		AF::ECS::Scene scene;
+		scene.Instantiate(GetSplitEnemyPrefab(), 4);
+
+		// Ages out the stamps written when the entities were created
+		scene.Update();
+		scene.Update();
+
+		std::vector<AF::ECS::EntityId> visited;
+		auto collect = [&scene, &visited]()
+		{
+			visited.clear();
+			scene.Each<AF::ECS::Changed<const Transform>>([&visited](AF::ECS::Entity& entity, const Transform&)
+			{
+				visited.push_back(entity.m_Id);
+			});
+		};
+
+		collect();
+		if (!visited.empty()) return false;
+
+		std::vector<AF::ECS::EntityId> ids;
+		scene.Each<const Transform>([&ids](AF::ECS::Entity& entity, const Transform&)
+		{
+			ids.push_back(entity.m_Id);
+		});
+
+		AF::ECS::EntityId written = ids[2];
+		scene.GetComponent<Transform>(written)->m_Position.x += 1.0f;
+		scene.Update();
+
+		collect();
+		if (visited.size() != 1 || visited[0] != written) return false;
+
+		scene.Update();
+
+		collect();
+		return visited.empty();
+	}
+}
+
+int main()
+{
+	AF::CreateLogger();
+	AF::s_Logger->set_level(spdlog::level::warn);
+
+	std::vector<Check> checks =
+	{
+		{ "snapshot_handles", CheckSnapshotHandles },
+		{ "changed_filter", CheckChangedFilter }
+	};
+
+	int failed = 0;
+
+	for (const Check& check : checks)
+	{
+		bool passed = check.m_Function();
+		std::printf("%s %s\n", passed ? "pass" : "FAIL", check.m_Name);
+		if (!passed) ++failed;
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+#include "AABB.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+	#define AF_SIMD_X86
+
+	#include <immintrin.h>
+
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define AF_TARGET_AVX
+	#else
+		#define AF_TARGET_AVX __attribute__((target("avx")))
+	#endif
+#endif
+
+namespace AF
+{
+	using OverlapKernel = void(*)(glm::vec2 min, glm::vec2 max, const AABBBatch& batch, uint64_t* mask);
+
+	// Tests boxes [begin, Size()), also finishes what the wider kernels leave over
+	static void OverlapTail(glm::vec2 min, glm::vec2 max, const AABBBatch& batch, size_t begin, uint64_t* mask)
+	{
+		for (size_t i = begin; i < batch.Size(); ++i)
+		{
+			bool hit = batch.m_MinX[i] < max.x && min.x < batch.m_MaxX[i] && batch.m_MinY[i] < max.y && min.y < batch.m_MaxY[i];
+			mask[i / 64] |= static_cast<uint64_t>(hit) << (i % 64);
+		}
+	}
+
+#ifndef AF_SIMD_X86
+	static void OverlapScalar(glm::vec2 min, glm::vec2 max, const AABBBatch& batch, uint64_t* mask)
+	{
+		OverlapTail(min, max, batch, 0, mask);
+	}
+#else
+	static void OverlapSSE(glm::vec2 min, glm::vec2 max, const AABBBatch& batch, uint64_t* mask)
+	{
+		__m128 minX = _mm_set1_ps(min.x), minY = _mm_set1_ps(min.y);
+		__m128 maxX = _mm_set1_ps(max.x), maxY = _mm_set1_ps(max.y);
+
+		size_t count = batch.Size() & ~size_t(3);
+
+		for (size_t i = 0; i < count; i += 4)
+		{
+			__m128 x = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(&batch.m_MinX[i]), maxX), _mm_cmplt_ps(minX, _mm_loadu_ps(&batch.m_MaxX[i])));
+			__m128 y = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(&batch.m_MinY[i]), maxY), _mm_cmplt_ps(minY, _mm_loadu_ps(&batch.m_MaxY[i])));
+
+			// Groups of 4 never straddle a mask word
+			mask[i / 64] |= static_cast<uint64_t>(_mm_movemask_ps(_mm_and_ps(x, y))) << (i % 64);
+		}
+
+		OverlapTail(min, max, batch, count, mask);
+	}
+
+	AF_TARGET_AVX static void OverlapAVX(glm::vec2 min, glm::vec2 max, const AABBBatch& batch, uint64_t* mask)
+	{
+		__m256 minX = _mm256_set1_ps(min.x), minY = _mm256_set1_ps(min.y);
+		__m256 maxX = _mm256_set1_ps(max.x), maxY = _mm256_set1_ps(max.y);
+
+		size_t count = batch.Size() & ~size_t(7);
+
+		for (size_t i = 0; i < count; i += 8)
+		{
+			__m256 x = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&batch.m_MinX[i]), maxX, _CMP_LT_OQ), _mm256_cmp_ps(minX, _mm256_loadu_ps(&batch.m_MaxX[i]), _CMP_LT_OQ));
+			__m256 y = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&batch.m_MinY[i]), maxY, _CMP_LT_OQ), _mm256_cmp_ps(minY, _mm256_loadu_ps(&batch.m_MaxY[i]), _CMP_LT_OQ));
+
+			mask[i / 64] |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_and_ps(x, y))) << (i % 64);
+		}
+
+		OverlapTail(min, max, batch, count, mask);
+	}
+
+	static bool SupportsAVX()
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+
+		// AVX and OSXSAVE, then make sure the OS saves the upper halves of the registers
+		bool avx = (info[2] & (1 << 28)) && (info[2] & (1 << 27));
+		return avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+		return __builtin_cpu_supports("avx");
+#endif
+	}
+#endif
+
+	static OverlapKernel SelectOverlapKernel()
+	{
+#ifdef AF_SIMD_X86
+		return SupportsAVX() ? OverlapAVX : OverlapSSE;
+#else
+		return OverlapScalar;
+#endif
+	}
+
+	void OverlapAABB(glm::vec2 min, glm::vec2 max, const AABBBatch& batch, std::vector<uint64_t>& mask)
+	{
+		static const OverlapKernel s_Kernel = SelectOverlapKernel();
+
+		mask.assign((batch.Size() + 63) / 64, 0);
+		if (batch.Size() != 0) s_Kernel(min, max, batch, mask.data());
+	}
+}
\ No newline at end of file
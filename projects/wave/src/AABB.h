@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace AF
+{
+	// Axis aligned boxes kept as one array per edge, the layout OverlapAABB reads
+	struct AABBBatch
+	{
+		void Clear()
+		{
+			m_MinX.clear();
+			m_MinY.clear();
+			m_MaxX.clear();
+			m_MaxY.clear();
+		}
+
+		void Push(glm::vec2 min, glm::vec2 max)
+		{
+			m_MinX.push_back(min.x);
+			m_MinY.push_back(min.y);
+			m_MaxX.push_back(max.x);
+			m_MaxY.push_back(max.y);
+		}
+
+		size_t Size() const
+		{
+			return m_MinX.size();
+		}
+
+		std::vector<float> m_MinX;
+		std::vector<float> m_MinY;
+		std::vector<float> m_MaxX;
+		std::vector<float> m_MaxY;
+	};
+
+	// Tests [min, max] against every box of the batch, bit i of the mask is set when box i overlaps it.
+	// Touching edges don't count as overlap. `mask` is resized to (count + 63) / 64 words.
+	// The first call picks the widest implementation the CPU supports, SSE or AVX on x86 and scalar code elsewhere.
+	void OverlapAABB(glm::vec2 min, glm::vec2 max, const AABBBatch& batch, std::vector<uint64_t>& mask);
+}
\ No newline at end of file
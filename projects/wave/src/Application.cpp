@@ -1,18 +1,21 @@
 #include "Application.h"
 
-#define NANOVG_GL3_IMPLEMENTATION
-
 #include <thread>
+#include <cmath>
+#include <chrono>
+
+#include "Log.h"
+#include "Debugger.h"
+
+// Headless builds provide their own Start, EarlyInit, Init and Destroy, see Headless.cpp
+#ifndef AF_HEADLESS
+
+#define NANOVG_GL3_IMPLEMENTATION
 
 #include <glad/glad.h>
 #include <nanovg.h>
 #include <nanovg_gl.h>
-#include <glm/gtc/random.hpp>
 
-#include "Log.h"
-#include "Debugger.h"
-
-#include <stdlib.h>
 #include <time.h>
 
 #include "Resources.h"
@@ -22,7 +25,10 @@
 
 void PickNextTrack(stb_vorbis** stream, int number = -1)
 {
-	std::string filename = fmt::format("res/music/{:0>2}.ogg", (number == -1 ? glm::linearRand<int>(0, 19) : number));
+	// Separate from the gameplay streams, when tracks change must not affect what the game draws
+	static AF::Random s_Random(static_cast<uint64_t>(time(nullptr)));
+
+	std::string filename = fmt::format("res/music/{:0>2}.ogg", (number == -1 ? s_Random.Int(0, 19) : number));
 
 	if (*stream) stb_vorbis_close(*stream);
 
@@ -37,8 +43,6 @@ void PickNextTrack(stb_vorbis** stream, int number = -1)
 
 void LoadDataIntoBuffer(stb_vorbis** stream, std::shared_ptr<AF::AudioBuffer> buffer)
 {
-	srand(time(nullptr));
-
 	if(*stream == nullptr) PickNextTrack(stream, -1);
 
 	buffer->m_Limit = stb_vorbis_get_samples_float_interleaved(*stream, buffer->m_Channels, buffer->m_Buffer, buffer->m_BufferSize) * buffer->m_Channels;
@@ -53,8 +57,11 @@ void LoadDataIntoBuffer(stb_vorbis** stream, std::shared_ptr<AF::AudioBuffer> bu
 	AF_TRACE("Loaded audio buffer");
 }
 
+#endif
+
 namespace AF
 {
+#ifndef AF_HEADLESS
 	void Application::Start()
 	{
 		if (m_Running) return;
@@ -111,6 +118,7 @@ namespace AF
 
 		AF_INFO("Stopped application");
 	}
+#endif
 
 	void Application::InvokeLater(const std::function<void()>& function)
 	{
@@ -127,10 +135,15 @@ namespace AF
 		m_Running = false;
 	}
 
+#ifndef AF_HEADLESS
 	void Application::EarlyInit()
 	{
 		AF_DEBUG("Starting EarlyInit");
 
+		m_Seed = static_cast<uint64_t>(time(nullptr));
+		m_Random.Seed(m_Seed);
+		AF_INFO("Seed {}", m_Seed);
+
 		AF_TRACE("Initializing glfw");
 		AF_ASSERT(glfwInit(), "Failed to initialze glfw");
 
@@ -231,21 +244,72 @@ namespace AF
 			}
 
 			virtual ~DebugGeneralInfo() = default;
-		}
-		generalDebugger;
+		};
+
+		struct DebugSimulationInfo : public AF::DebuggerSection
+		{
+			DebugSimulationInfo()
+			{
+				m_Title = "Simulation";
+			}
 
-		AF::Debugger::s_Sections.push_back(generalDebugger);
+			virtual ~DebugSimulationInfo() = default;
+
+			virtual void Update() override
+			{
+				auto* app = AF::GetApplication();
+
+				m_Content.clear();
+				m_Content.push_back(std::make_pair("Tick Rate", fmt::format("{:.0f} Hz", 1.0 / app->m_FixedDeltaTime)));
+				m_Content.push_back(std::make_pair("Ticks This Frame", std::to_string(app->m_FrameTicks)));
+				m_Content.push_back(std::make_pair("Tick Cost", fmt::format("{:.3f} ms", app->m_TickDuration * 1000.0)));
+				m_Content.push_back(std::make_pair("Frame Time", fmt::format("{:.3f} ms", app->m_DeltaTime * 1000.0)));
+			}
+		};
+
+		static DebugGeneralInfo generalDebugger;
+		static DebugSimulationInfo simulationDebugger;
+		AF::Debugger::s_Sections.push_back(&generalDebugger);
+		AF::Debugger::s_Sections.push_back(&simulationDebugger);
 	}
+#endif
 
 	void Application::Update()
 	{
+		m_Accumulator += m_DeltaTime;
+		m_FrameTicks = 0;
+
+		auto tickStart = std::chrono::steady_clock::now();
+
+		while (m_Accumulator >= m_FixedDeltaTime && m_FrameTicks < m_MaxTicksPerFrame)
+		{
+			m_StateManager.FixedUpdate();
+
+			m_Accumulator -= m_FixedDeltaTime;
+			++m_FrameTicks;
+			++m_Tick;
+		}
+
+		if (m_FrameTicks != 0)
+			m_TickDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - tickStart).count() / m_FrameTicks;
+
+		// Out of catch up budget, the whole ticks that are left are skipped
+		if (m_Accumulator >= m_FixedDeltaTime)
+			m_Accumulator = std::fmod(m_Accumulator, m_FixedDeltaTime);
+
+		m_Interpolation = static_cast<float>(m_Accumulator / m_FixedDeltaTime);
+
+#ifndef AF_HEADLESS
 		glViewport(0, 0, static_cast<int>(m_Size.x), static_cast<int>(m_Size.y));
 		glClearColor(0, 0, 0, 1);
 		glClear(GL_COLOR_BUFFER_BIT);
+#endif
 
 		m_StateManager.Update();
 
+#ifndef AF_HEADLESS
 		glfwSwapBuffers(m_Window);
+#endif
 
 		m_PressedKeys.clear();
 
@@ -266,6 +330,7 @@ namespace AF
 		}
 	}
 
+#ifndef AF_HEADLESS
 	void Application::Destroy()
 	{
 		AF_DEBUG("Destroying nanovg");
@@ -279,6 +344,7 @@ namespace AF
 		AF_DEBUG("Destroying glfw");
 		glfwTerminate();
 	}
+#endif
 
 	void Application::Resize(glm::vec2 size)
 	{
@@ -4,14 +4,20 @@
 #include <functional>
 #include <unordered_set>
 #include <mutex>
+#include <cstdint>
+#include <string>
 
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <nanovg.h>
 
+#ifndef AF_HEADLESS
 #include "Audio.h"
+#endif
 #include "State.h"
 #include "Renderer.h"
+#include "JobSystem.h"
+#include "Random.h"
 
 namespace AF
 {
@@ -39,14 +45,44 @@ namespace AF
 
 		std::mutex m_FutureMutex;
 
+		// Command line, without the program name
+		std::vector<std::string> m_Arguments;
+
 		bool m_Running = false;
 		glm::vec2 m_Size = { 1280, 720 };
 		glm::vec2 m_ReferenceSize = { 1280, 720 };
 		const char* m_Title = "Wave";
+
+		// Time the last frame took
 		double m_DeltaTime = 0.0f;
+
+		// The simulation advances in ticks of m_FixedDeltaTime no matter the frame rate, a slow frame is caught up on
+		// with several ticks. Past m_MaxTicksPerFrame the remaining time is dropped so the game slows down instead of
+		// falling further behind every frame.
+		double m_FixedDeltaTime = 1.0 / 120.0;
+		int m_MaxTicksPerFrame = 8;
+		uint64_t m_Tick = 0;
+
+		// Frame time not yet simulated
+		double m_Accumulator = 0.0;
+
+		// How far the current frame is between the last tick and the next one, in [0, 1)
+		float m_Interpolation = 0.0f;
+
+		// Ticks run by the last frame and how long they took on average
+		int m_FrameTicks = 0;
+		double m_TickDuration = 0.0;
+
+		// Seeds every scene, see SeedScene in Game.cpp
+		uint64_t m_Seed = 0;
+		Random m_Random;
+
 		Renderer m_Renderer;
 		GLFWwindow* m_Window = nullptr;
+#ifndef AF_HEADLESS
 		AudioMaster m_AudioMaster = AudioMaster();
+#endif
+		JobSystem m_JobSystem;
 
 		StateManager m_StateManager;
 	};
@@ -0,0 +1,97 @@
+#include "CommandBuffer.h"
+
+#include "Log.h"
+
+namespace AF::ECS
+{
+	CommandBuffer::~CommandBuffer()
+	{
+		Clear();
+	}
+
+	EntityId CommandBuffer::NextPendingId()
+	{
+		AF_ASSERT(m_PendingCount < s_PendingBit, "Too many entities created in one command buffer");
+		return { s_PendingBit | m_PendingCount++, 0 };
+	}
+
+	EntityId CommandBuffer::Resolve(EntityId id) const
+	{
+		if (id.m_Index == EntityId().m_Index || !(id.m_Index & s_PendingBit)) return id;
+
+		uint32_t index = id.m_Index & ~s_PendingBit;
+		return index < m_Created.size() ? m_Created[index] : EntityId();
+	}
+
+	EntityId CommandBuffer::CreateEntity()
+	{
+		EntityId id = NextPendingId();
+		m_Commands.push_back({ Command::CREATE_ENTITY, id, nullptr, nullptr, nullptr });
+		return id;
+	}
+
+	EntityId CommandBuffer::Instantiate(const Prefab& prefab)
+	{
+		EntityId id = NextPendingId();
+		m_Commands.push_back({ Command::INSTANTIATE, id, nullptr, &prefab, nullptr });
+		return id;
+	}
+
+	void CommandBuffer::DestroyEntity(EntityId id)
+	{
+		m_Commands.push_back({ Command::DESTROY_ENTITY, id, nullptr, nullptr, nullptr });
+	}
+
+	void CommandBuffer::Playback(Scene& scene)
+	{
+		m_Created.resize(m_PendingCount);
+
+		for (Command& command : m_Commands)
+		{
+			switch (command.m_Type)
+			{
+			case Command::CREATE_ENTITY:
+				m_Created[command.m_Entity.m_Index & ~s_PendingBit] = scene.CreateEntity().m_Id;
+				break;
+			case Command::INSTANTIATE:
+				m_Created[command.m_Entity.m_Index & ~s_PendingBit] = scene.Instantiate(*command.m_Prefab).m_Id;
+				break;
+			case Command::DESTROY_ENTITY:
+				scene.DestroyEntity(Resolve(command.m_Entity));
+				break;
+			case Command::CREATE_COMPONENT:
+			{
+				// The target may have died since the command was recorded, the payload is dropped then
+				if (void* data = scene.AddComponent(Resolve(command.m_Entity), *command.m_Info))
+					command.m_Info->m_Relocate(data, command.m_Data);
+				else
+					command.m_Info->m_Destroy(command.m_Data);
+
+				m_Pool.Free(command.m_Data, command.m_Info->m_Size);
+				command.m_Data = nullptr;
+				break;
+			}
+			case Command::DESTROY_COMPONENT:
+				scene.RemoveComponent(Resolve(command.m_Entity), *command.m_Info);
+				break;
+			}
+		}
+
+		m_Commands.clear();
+		m_PendingCount = 0;
+	}
+
+	void CommandBuffer::Clear()
+	{
+		for (Command& command : m_Commands)
+		{
+			if (!command.m_Data) continue;
+
+			command.m_Info->m_Destroy(command.m_Data);
+			m_Pool.Free(command.m_Data, command.m_Info->m_Size);
+		}
+
+		m_Commands.clear();
+		m_PendingCount = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "ECS.h"
+#include "Pool.h"
+
+namespace AF::ECS
+{
+	// Records structural changes so code running alongside other systems can request them without touching the scene.
+	// A buffer is only ever written by one thread at a time, Playback applies the commands in the order they were recorded.
+	// Ids returned by CreateEntity and Instantiate are placeholders, they may be passed to later commands of the same buffer
+	// but mean nothing to the scene and stop being valid once the buffer is played back.
+	class CommandBuffer final
+	{
+	public:
+		CommandBuffer() = default;
+		CommandBuffer(const CommandBuffer&) = delete;
+		~CommandBuffer();
+
+		CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+		EntityId CreateEntity();
+		EntityId Instantiate(const Prefab& prefab);
+		void DestroyEntity(EntityId id);
+
+		// The component is constructed now and moved into the scene on playback
+		template<typename t_Type, typename... t_Args>
+		void CreateComponent(EntityId id, t_Args&&... args)
+		{
+			const ComponentInfo& info = GetComponentInfo<t_Type>();
+
+			void* data = m_Pool.Allocate(info.m_Size);
+			new (data) t_Type(std::forward<t_Args>(args)...);
+
+			m_Commands.push_back({ Command::CREATE_COMPONENT, id, &info, nullptr, data });
+		}
+
+		template<typename t_Type>
+		void DestroyComponent(EntityId id)
+		{
+			m_Commands.push_back({ Command::DESTROY_COMPONENT, id, &GetComponentInfo<t_Type>(), nullptr, nullptr });
+		}
+
+		bool Empty() const
+		{
+			return m_Commands.empty();
+		}
+
+		// Applies and then drops every recorded command, must not run while systems are using the scene
+		void Playback(Scene& scene);
+
+		// Drops every recorded command without applying it
+		void Clear();
+	private:
+		struct Command
+		{
+			enum Type : uint8_t
+			{
+				CREATE_ENTITY, INSTANTIATE, DESTROY_ENTITY, CREATE_COMPONENT, DESTROY_COMPONENT
+			};
+
+			Type m_Type;
+			EntityId m_Entity;
+			const ComponentInfo* m_Info;
+			const Prefab* m_Prefab;
+			void* m_Data;
+		};
+
+		// Placeholder ids have this bit set in their index, the rest of the index counts creations within the buffer
+		static constexpr uint32_t s_PendingBit = 1u << 31;
+
+		EntityId NextPendingId();
+		EntityId Resolve(EntityId id) const;
+
+		std::vector<Command> m_Commands;
+		uint32_t m_PendingCount = 0;
+
+		// Real ids of the placeholders, filled in during playback
+		std::vector<EntityId> m_Created;
+
+		// Component payloads, blocks are reused from one frame to the next
+		BlockPool m_Pool;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "ECS.h"
+#include "Timer.h"
+#include "Random.h"
+
+// User defined, the area spawners place entities in
+glm::vec2 GetWorldSize();
+
+// Scene tags, see AF::ECS::Scene::GetTagged
+namespace EntityTag
+{
+	enum EntityTagType : AF::ECS::Tag
+	{
+		NONE = 0, PLAYER, ENEMY
+	};
+}
+
+// Indices into a scene's AF::RandomStreams, one per system that draws numbers
+namespace RandomStream
+{
+	enum RandomStreamType : size_t
+	{
+		SPAWN = 0, SPLIT, FLASHER, EFFECTS
+	};
+}
+
+struct Transform
+{
+	Transform(glm::vec2 position = { 0.0f, 0.0f }, glm::vec2 size = { 32.0f, 32.0f })
+		: m_Position(position), m_Size(size), m_PreviousPosition(position)
+	{
+	}
+
+	// Position between the last two simulation ticks, `alpha` is Application::m_Interpolation
+	glm::vec2 Interpolate(float alpha) const
+	{
+		return glm::mix(m_PreviousPosition, m_Position, alpha);
+	}
+
+	glm::vec2 m_Position;
+	glm::vec2 m_Size;
+
+	// Where the tick started, MovementSystem keeps it up to date
+	glm::vec2 m_PreviousPosition;
+};
+
+struct BoxRenderer
+{
+	BoxRenderer(glm::vec4 color = { 1.0f, 1.0f, 1.0f, 1.0f })
+		: m_Color(color)
+	{
+	}
+
+	glm::vec4 m_Color;
+};
+
+struct RigidBody
+{
+	RigidBody(glm::vec2 velocity = { 0.0f, 0.0f })
+		: m_Velocity(velocity)
+	{
+	}
+
+	glm::vec2 m_Velocity;
+};
+
+struct EdgeSpawner
+{
+	void Start(AF::ECS::Entity& entity)
+	{
+		Transform* transform = entity.GetComponent<Transform>();
+		RigidBody* rigidBody = entity.GetComponent<RigidBody>();
+
+		if (transform && rigidBody)
+		{
+			glm::vec2 worldSize = GetWorldSize();
+			AF::Random& random = entity.m_Scene->GetResource<AF::RandomStreams>().Get(RandomStream::SPAWN);
+
+			int direction = random.Int(0, 3);
+			float speed = random.Float(300.0f, 600.0f);
+
+			transform->m_Position.x = random.Float(-transform->m_Size.x, worldSize.x);
+			transform->m_Position.y = random.Float(-transform->m_Size.y, worldSize.y);
+
+			switch (direction)
+			{
+				case 0:
+					rigidBody->m_Velocity = { 0, 1 };
+					transform->m_Position.y = -transform->m_Size.y;
+					break;
+				case 1:
+					rigidBody->m_Velocity = { 0, -1 };
+					transform->m_Position.y = worldSize.y;
+					break;
+				case 2:
+					rigidBody->m_Velocity = { 1, 0 };
+					transform->m_Position.x = -transform->m_Size.x;
+					break;
+				case 3:
+					rigidBody->m_Velocity = { -1, 0 };
+					transform->m_Position.x = worldSize.x;
+					break;
+			}
+
+			rigidBody->m_Velocity *= speed;
+		}
+	}
+};
+
+struct Flasher
+{
+};
+
+struct EdgeKiller
+{
+};
+
+struct TrailSpawner
+{
+	TrailSpawner(float timerLenth = 0.01f)
+		: m_Timer(timerLenth)
+	{
+	}
+
+	AF::Timer<float> m_Timer;
+};
+
+struct EdgeBouncer
+{
+};
+
+struct EdgeClamper
+{
+};
+
+struct RandomSpawner
+{
+	RandomSpawner(glm::vec2 speedRange = { 100.0f, 500.0f })
+		: m_SpeedRange(speedRange)
+	{
+	}
+
+	void Start(AF::ECS::Entity& entity)
+	{
+		Transform* transform = entity.GetComponent<Transform>();
+		RigidBody* rigidBody = entity.GetComponent<RigidBody>();
+
+		if (transform && rigidBody)
+		{
+			glm::vec2 worldSize = GetWorldSize();
+			AF::Random& random = entity.m_Scene->GetResource<AF::RandomStreams>().Get(RandomStream::SPAWN);
+
+			do
+			{
+				rigidBody->m_Velocity.x = random.Float(-m_SpeedRange[1], m_SpeedRange[1]);
+				rigidBody->m_Velocity.y = random.Float(-m_SpeedRange[1], m_SpeedRange[1]);
+			}
+			while (glm::length(rigidBody->m_Velocity) < m_SpeedRange[0]);
+
+			transform->m_Position.x = random.Float(0.0f, worldSize.x - transform->m_Size.x);
+			transform->m_Position.y = random.Float(0.0f, worldSize.y - transform->m_Size.y);
+		}
+	}
+
+	glm::vec2 m_SpeedRange;
+};
+
+struct CenterSpawner
+{
+	void Start(AF::ECS::Entity& entity)
+	{
+		if (Transform* transform = entity.GetComponent<Transform>())
+		{
+			glm::vec2 worldSize = GetWorldSize();
+			transform->m_Position = (worldSize - transform->m_Size) / 2.0f;
+		}
+	}
+};
+
+struct PlayerControlled
+{
+	glm::vec2 m_SpeedRange;
+	float m_MaxHealth = 100.0f;
+	float m_CurrentHealth = 100.0f;
+};
\ No newline at end of file
@@ -20,9 +20,13 @@ namespace AF
 
 	namespace Debugger
 	{
-		extern std::vector<DebuggerSection> s_Sections;
+		// Sections are not owned, a section must be removed before it is destroyed
+		extern std::vector<DebuggerSection*> s_Sections;
 		extern bool s_Enabled;
 
+		// Updates every section and lays them out as plain text
+		std::string Format();
+
 		void Update();
 	}
 }
\ No newline at end of file
@@ -1,82 +1,624 @@
 #include "ECS.h"
 
-#include "Application.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if !defined(_MSC_VER)
+	#include <cxxabi.h>
+#endif
+
+#include "Log.h"
 
 namespace AF::ECS
 {
-	void Component::Start()
+	namespace Detail
+	{
+		static std::array<const ComponentInfo*, MaxComponents> s_ComponentInfos = {};
+
+		ComponentId NextComponentId()
+		{
+			static std::atomic<ComponentId> s_NextId = 0;
+
+			ComponentId id = s_NextId++;
+			AF_ASSERT(id < MaxComponents, "Too many component types, raise AF::ECS::MaxComponents");
+			return id;
+		}
+
+		size_t NextResourceId()
+		{
+			static std::atomic<size_t> s_NextId = 0;
+
+			size_t id = s_NextId++;
+			AF_ASSERT(id < MaxResources, "Too many resource types, raise AF::ECS::MaxResources");
+			return id;
+		}
+
+		void RegisterComponent(const ComponentInfo& info)
+		{
+			s_ComponentInfos[info.m_Id] = &info;
+		}
+
+		const ComponentInfo* FindComponentInfo(ComponentId id)
+		{
+			return s_ComponentInfos[id];
+		}
+
+		const ComponentInfo* FindComponentInfoByHash(uint64_t typeHash)
+		{
+			for (const ComponentInfo* info : s_ComponentInfos)
+			{
+				if (info && info->m_TypeHash == typeHash) return info;
+			}
+
+			return nullptr;
+		}
+
+		uint64_t HashTypeName(const char* name)
+		{
+			// FNV-1a
+			uint64_t hash = 14695981039346656037ull;
+
+			for (; *name; ++name)
+			{
+				hash ^= static_cast<unsigned char>(*name);
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		}
+
+		const char* ReadableTypeName(const char* name)
+		{
+#if defined(_MSC_VER)
+			// MSVC names are already readable apart from the kind of type in front
+			for (const char* prefix : { "struct ", "class ", "enum " })
+			{
+				size_t length = std::strlen(prefix);
+				if (std::strncmp(name, prefix, length) == 0) return name + length;
+			}
+
+			return name;
+#else
+			// Demangled once per component type and never freed
+			int status = 0;
+			char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+			return status == 0 && demangled ? demangled : name;
+#endif
+		}
+	}
+
+	Column::Column(const ComponentInfo* info, BlockPool* pool)
+		: m_Info(info), m_Pool(pool)
 	{
 	}
 
-	void Component::Update()
+	Column::Column(Column&& other) noexcept
+		: m_Info(other.m_Info), m_Pool(other.m_Pool), m_Data(other.m_Data), m_Versions(other.m_Versions), m_Capacity(other.m_Capacity)
 	{
+		other.m_Data = nullptr;
+		other.m_Versions = nullptr;
+		other.m_Capacity = 0;
 	}
 
-	Entity::Entity(std::weak_ptr<Scene> scene)
+	Column::~Column()
 	{
-		m_Scene = scene;
+		m_Pool->Free(m_Data, m_Capacity * m_Info->m_Size);
+		m_Pool->Free(m_Versions, m_Capacity * sizeof(uint32_t));
 	}
 
-	void Entity::Update()
+	void Column::Reserve(size_t capacity, size_t count)
 	{
-		if (m_FirstFrame)
+		if (capacity <= m_Capacity) return;
+
+		std::byte* data = static_cast<std::byte*>(m_Pool->Allocate(capacity * m_Info->m_Size));
+
+		uint32_t* versions = static_cast<uint32_t*>(m_Pool->Allocate(capacity * sizeof(uint32_t)));
+
+		for (size_t i = 0; i < count; ++i)
+			m_Info->m_Relocate(data + i * m_Info->m_Size, Get(i));
+
+		if (count != 0)
+			std::copy(m_Versions, m_Versions + count, versions);
+
+		m_Pool->Free(m_Data, m_Capacity * m_Info->m_Size);
+		m_Pool->Free(m_Versions, m_Capacity * sizeof(uint32_t));
+
+		m_Data = data;
+		m_Versions = versions;
+		m_Capacity = capacity;
+	}
+
+	Archetype::Archetype(Signature signature, BlockPool* pool)
+		: m_Signature(signature)
+	{
+		m_ColumnIndex.fill(-1);
+		m_Columns.reserve(signature.count());
+
+		for (ComponentId id = 0; id < MaxComponents; ++id)
 		{
-			for (auto [key, value] : m_Components)
-				value->Start();
+			if (!signature.test(id)) continue;
+
+			const ComponentInfo* info = Detail::FindComponentInfo(id);
 
-			m_FirstFrame = false;
+			m_ColumnIndex[id] = static_cast<int16_t>(m_Columns.size());
+			m_Columns.emplace_back(info, pool);
+			m_TriviallyDestructible = m_TriviallyDestructible && info->m_TriviallyDestructible;
 		}
+	}
+
+	void Archetype::Reserve(size_t capacity)
+	{
+		if (capacity <= m_Capacity) return;
 
-		for (auto [key, value] : m_Components)
-			value->Update();
+		m_Capacity = std::max({ capacity, m_Capacity * 2, size_t(16) });
+
+		for (Column& column : m_Columns)
+			column.Reserve(m_Capacity, m_Entities.size());
+
+		m_Entities.reserve(m_Capacity);
+	}
+
+	size_t Archetype::PushRow(EntityId id)
+	{
+		size_t row = m_Entities.size();
+		Reserve(row + 1);
+
+		m_Entities.push_back(id);
+		return row;
+	}
+
+	EntityId Archetype::SwapRemove(size_t row)
+	{
+		// The components at `row` must already be destroyed or relocated
+		size_t last = m_Entities.size() - 1;
+		EntityId moved = {};
+
+		if (row != last)
+		{
+			for (Column& column : m_Columns)
+			{
+				column.m_Info->m_Relocate(column.Get(row), column.Get(last));
+				column.m_Versions[row] = column.m_Versions[last];
+			}
+
+			moved = m_Entities[last];
+			m_Entities[row] = moved;
+		}
+
+		m_Entities.pop_back();
+		return moved;
+	}
+
+	void Archetype::Clear()
+	{
+		if (!m_TriviallyDestructible)
+		{
+			for (Column& column : m_Columns)
+			{
+				if (column.m_Info->m_TriviallyDestructible) continue;
+
+				for (size_t row = 0; row < m_Entities.size(); ++row)
+					column.m_Info->m_Destroy(column.Get(row));
+			}
+		}
+
+		m_Entities.clear();
+	}
+
+	Prefab::~Prefab()
+	{
+		for (Prototype& prototype : m_Components)
+			prototype.m_Info->m_Destroy(prototype.m_Data.get());
+	}
+
+	void Entity::SetTag(Tag tag)
+	{
+		if (m_Scene) m_Scene->SetTag(m_Id, tag);
+	}
+
+	Tag Entity::GetTag() const
+	{
+		return m_Scene ? m_Scene->GetTag(m_Id) : 0;
+	}
+
+	bool Entity::IsValid() const
+	{
+		return m_Scene && m_Scene->IsValid(m_Id);
 	}
 
 	void Entity::Kill()
 	{
-		if (std::shared_ptr<Scene> scene = m_Scene.lock())
-			scene->DestroyEntity(shared_from_this());
+		if (m_Scene) m_Scene->DestroyEntity(m_Id);
+	}
+
+	Scene::Scene()
+	{
+		m_EmptyArchetype = FindArchetype({});
 	}
 
 	Scene::~Scene()
 	{
 		Clear();
+
+		for (Resource& resource : m_Resources)
+		{
+			if (resource.m_Data) resource.m_Destroy(resource.m_Data);
+		}
 	}
 
-	std::shared_ptr<Entity> Scene::CreateEntity()
+	Entity Scene::CreateEntity()
 	{
-		std::shared_ptr<Entity> entity = std::make_shared<Entity>(weak_from_this());
-		m_Entities.push_back(entity);
-		return entity;
+		return Entity(this, NewRecord(m_EmptyArchetype));
 	}
 
-	std::shared_ptr<Entity> Scene::DestroyEntity(std::shared_ptr<Entity> entity)
+	Entity Scene::Instantiate(const Prefab& prefab)
 	{
-		AF::GetApplication()->InvokeLater([entity, this]()
+		Archetype* archetype;
+		size_t row = InstantiateRows(prefab, 1, archetype);
+		return Entity(this, archetype->m_Entities[row]);
+	}
+
+	void Scene::Instantiate(const Prefab& prefab, size_t count)
+	{
+		Archetype* archetype;
+		InstantiateRows(prefab, count, archetype);
+	}
+
+	size_t Scene::InstantiateRows(const Prefab& prefab, size_t count, Archetype*& archetype)
+	{
+		archetype = FindArchetype(prefab.m_Signature);
+
+		size_t first = archetype->Size();
+		archetype->Reserve(first + count);
+
+		size_t newRecords = count - std::min(count, m_FreeIndices.size());
+		if (m_Records.size() + newRecords > m_Records.capacity())
+			m_Records.reserve(std::max(m_Records.size() + newRecords, m_Records.capacity() * 2));
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			EntityId id = NewRecord(archetype);
+			if (prefab.m_Tag) SetTag(id, prefab.m_Tag);
+		}
+
+		for (const Prefab::Prototype& prototype : prefab.m_Components)
+		{
+			Column* column = archetype->FindColumn(prototype.m_Info->m_Id);
+
+			for (size_t row = first; row < first + count; ++row)
+				prototype.m_Info->m_Copy(column->Get(row), prototype.m_Data.get());
+
+			std::fill(column->m_Versions + first, column->m_Versions + first + count, m_ChangeTick);
+		}
+
+		for (size_t row = first; row < first + count; ++row)
 		{
-			if (!m_Entities.empty())
+			for (const Prefab::Prototype& prototype : prefab.m_Components)
 			{
-				m_Entities.erase(std::remove(m_Entities.begin(), m_Entities.end(), entity));
-				entity->m_Scene = {};
+				if (prototype.m_Info->m_Start)
+					m_PendingStarts.push_back({ archetype->m_Entities[row], prototype.m_Info->m_Id });
 			}
-		});		
-		return entity;
+		}
+
+		return first;
+	}
+
+	EntityId Scene::NewRecord(Archetype* archetype)
+	{
+		uint32_t index;
+
+		if (m_FreeIndices.empty())
+		{
+			index = static_cast<uint32_t>(m_Records.size());
+			m_Records.emplace_back().m_Generation = m_GenerationBase;
+		}
+		else
+		{
+			index = m_FreeIndices.back();
+			m_FreeIndices.pop_back();
+		}
+
+		EntityRecord& record = m_Records[index];
+		EntityId id = { index, record.m_Generation };
+		m_NextGeneration = std::max(m_NextGeneration, record.m_Generation + 1);
+
+		record.m_Archetype = archetype;
+		record.m_Row = static_cast<uint32_t>(archetype->PushRow(id));
+
+		++m_EntityCount;
+		++m_EntitiesCreated;
+		return id;
+	}
+
+	void Scene::DestroyEntity(EntityId id)
+	{
+		if (!IsValid(id)) return;
+
+		EntityRecord& record = m_Records[id.m_Index];
+		if (record.m_Dead) return;
+
+		record.m_Dead = true;
+		m_PendingDestroy.push_back(id);
+	}
+
+	void Scene::FlushDestroyed()
+	{
+		if (m_PendingDestroy.empty()) return;
+
+		// Kills from parallel systems arrive in any order, putting them in index order keeps the resulting row order
+		// deterministic. An LSD radix sort over the index bytes, only as many passes as the largest index needs.
+		uint32_t largest = 0;
+		for (EntityId id : m_PendingDestroy)
+			largest = std::max(largest, id.m_Index);
+
+		m_DestroyScratch.resize(m_PendingDestroy.size());
+
+		for (uint32_t shift = 0; shift < 32 && (largest >> shift); shift += 8)
+		{
+			std::array<size_t, 256> offsets = {};
+
+			for (EntityId id : m_PendingDestroy)
+				++offsets[(id.m_Index >> shift) & 0xFF];
+
+			size_t offset = 0;
+			for (size_t& bucket : offsets)
+				offset += std::exchange(bucket, offset);
+
+			for (EntityId id : m_PendingDestroy)
+				m_DestroyScratch[offsets[(id.m_Index >> shift) & 0xFF]++] = id;
+
+			m_PendingDestroy.swap(m_DestroyScratch);
+		}
+
+		// Each removal is a swap-and-pop within its archetype, so a frame costs O(k) in the number of kills
+		for (EntityId id : m_PendingDestroy)
+			RemoveEntity(id);
+
+		m_PendingDestroy.clear();
+	}
+
+	void Scene::SetTag(EntityId id, Tag tag)
+	{
+		if (!IsValid(id)) return;
+
+		EntityRecord& record = m_Records[id.m_Index];
+		if (record.m_Tag == tag) return;
+
+		if (record.m_Tag)
+		{
+			std::vector<EntityId>& tagged = m_Tagged[record.m_Tag];
+
+			EntityId moved = tagged.back();
+			tagged[record.m_TagSlot] = moved;
+			m_Records[moved.m_Index].m_TagSlot = record.m_TagSlot;
+			tagged.pop_back();
+		}
+
+		record.m_Tag = tag;
+
+		if (tag)
+		{
+			if (tag >= m_Tagged.size())
+				m_Tagged.resize(tag + 1);
+
+			record.m_TagSlot = static_cast<uint32_t>(m_Tagged[tag].size());
+			m_Tagged[tag].push_back(id);
+		}
+	}
+
+	void* Scene::AddComponent(EntityId id, const ComponentInfo& info)
+	{
+		if (!IsValid(id)) return nullptr;
+
+		if (info.m_Start)
+			m_PendingStarts.push_back({ id, info.m_Id });
+
+		EntityRecord& record = m_Records[id.m_Index];
+		Archetype* current = record.m_Archetype;
+
+		if (Column* column = current->FindColumn(info.m_Id))
+		{
+			void* data = column->Get(record.m_Row);
+			info.m_Destroy(data);
+			column->m_Versions[record.m_Row] = m_ChangeTick;
+			return data;
+		}
+
+		Archetype*& target = current->m_AddEdges[info.m_Id];
+
+		if (!target)
+			target = FindArchetype(Signature(current->m_Signature).set(info.m_Id));
+
+		Archetype* destination = target;
+		MoveEntity(id, destination);
+
+		Column* column = destination->FindColumn(info.m_Id);
+		column->m_Versions[record.m_Row] = m_ChangeTick;
+		return column->Get(record.m_Row);
+	}
+
+	void Scene::RemoveComponent(EntityId id, const ComponentInfo& info)
+	{
+		if (!IsValid(id)) return;
+
+		Archetype* current = m_Records[id.m_Index].m_Archetype;
+		if (!current->m_Signature.test(info.m_Id)) return;
+
+		Archetype*& target = current->m_RemoveEdges[info.m_Id];
+
+		if (!target)
+			target = FindArchetype(Signature(current->m_Signature).reset(info.m_Id));
+
+		MoveEntity(id, target);
+	}
+
+	Archetype* Scene::FindArchetype(Signature signature)
+	{
+		auto result = m_ArchetypeLookup.find(signature);
+		if (result != m_ArchetypeLookup.end()) return result->second;
+
+		m_Archetypes.push_back(std::make_unique<Archetype>(signature, &m_Pool));
+		Archetype* archetype = m_Archetypes.back().get();
+		m_ArchetypeLookup[signature] = archetype;
+		return archetype;
+	}
+
+	void Scene::MoveEntity(EntityId id, Archetype* target)
+	{
+		EntityRecord& record = m_Records[id.m_Index];
+		Archetype* source = record.m_Archetype;
+		size_t sourceRow = record.m_Row;
+		size_t targetRow = target->PushRow(id);
+
+		// Components missing from the target are destroyed, new ones are left for the caller to construct
+		for (Column& column : source->m_Columns)
+		{
+			if (Column* destination = target->FindColumn(column.m_Info->m_Id))
+			{
+				column.m_Info->m_Relocate(destination->Get(targetRow), column.Get(sourceRow));
+				destination->m_Versions[targetRow] = column.m_Versions[sourceRow];
+			}
+			else
+				column.m_Info->m_Destroy(column.Get(sourceRow));
+		}
+
+		EntityId moved = source->SwapRemove(sourceRow);
+		if (moved.m_Index != EntityId().m_Index)
+			m_Records[moved.m_Index].m_Row = static_cast<uint32_t>(sourceRow);
+
+		record.m_Archetype = target;
+		record.m_Row = static_cast<uint32_t>(targetRow);
+	}
+
+	void Scene::RemoveEntity(EntityId id)
+	{
+		EntityRecord& record = m_Records[id.m_Index];
+		Archetype* archetype = record.m_Archetype;
+
+		for (Column& column : archetype->m_Columns)
+			column.m_Info->m_Destroy(column.Get(record.m_Row));
+
+		EntityId moved = archetype->SwapRemove(record.m_Row);
+		if (moved.m_Index != EntityId().m_Index)
+			m_Records[moved.m_Index].m_Row = record.m_Row;
+
+		SetTag(id, 0);
+
+		record.m_Archetype = nullptr;
+		record.m_Dead = false;
+
+		// Normally a no-op, a record restored by LoadSnapshot can be older than handles given out before the load
+		record.m_Generation = std::max(record.m_Generation + 1, m_GenerationBase);
+		m_FreeIndices.push_back(id.m_Index);
+		--m_EntityCount;
+		++m_EntitiesDestroyed;
 	}
 
 	void Scene::Clear()
 	{
-		for (auto entity : m_Entities)
-			entity->m_Scene = {};
+		for (auto& archetype : m_Archetypes)
+			archetype->Clear();
 
-		m_Entities.clear();
+		// Records are plain data, dropping them and raising the base generation invalidates every old handle
+		m_Records.clear();
+		m_FreeIndices.clear();
+		m_PendingDestroy.clear();
+		m_PendingStarts.clear();
+
+		for (std::vector<EntityId>& tagged : m_Tagged)
+			tagged.clear();
+
+		m_GenerationBase = m_NextGeneration;
+		m_EntitiesDestroyed += m_EntityCount;
+		m_EntityCount = 0;
 	}
 
 	void Scene::Update()
 	{
-		//for (auto entity : m_Entities)
-		for (int i = m_Entities.size() - 1; i >= 0; --i)
+		++m_ChangeTick;
+		FlushDestroyed();
+		RunPendingStarts();
+
+		SceneChurn churn = GetChurn();
+		m_FrameChurn.m_EntitiesCreated = churn.m_EntitiesCreated - m_FrameStartChurn.m_EntitiesCreated;
+		m_FrameChurn.m_EntitiesDestroyed = churn.m_EntitiesDestroyed - m_FrameStartChurn.m_EntitiesDestroyed;
+		m_FrameChurn.m_BlockAllocations = churn.m_BlockAllocations - m_FrameStartChurn.m_BlockAllocations;
+		m_FrameChurn.m_BlockFrees = churn.m_BlockFrees - m_FrameStartChurn.m_BlockFrees;
+		m_FrameStartChurn = churn;
+	}
+
+	SceneChurn Scene::GetChurn() const
+	{
+		return { m_EntitiesCreated, m_EntitiesDestroyed, m_Pool.Allocations(), m_Pool.Frees() };
+	}
+
+	void Scene::GetStats(SceneStats& stats) const
+	{
+		std::array<ComponentStats, MaxComponents> components = {};
+
+		stats.m_IndexUsedBytes = m_Records.size() * sizeof(EntityRecord) + m_FreeIndices.size() * sizeof(uint32_t);
+		stats.m_IndexReservedBytes = m_Records.capacity() * sizeof(EntityRecord) + m_FreeIndices.capacity() * sizeof(uint32_t);
+
+		for (auto& archetype : m_Archetypes)
+		{
+			stats.m_IndexUsedBytes += archetype->m_Entities.size() * sizeof(EntityId);
+			stats.m_IndexReservedBytes += archetype->m_Entities.capacity() * sizeof(EntityId);
+
+			for (const Column& column : archetype->m_Columns)
+			{
+				size_t rowSize = column.m_Info->m_Size + sizeof(uint32_t);
+
+				ComponentStats& component = components[column.m_Info->m_Id];
+				component.m_Info = column.m_Info;
+				component.m_Count += archetype->Size();
+				component.m_UsedBytes += archetype->Size() * rowSize;
+				component.m_ReservedBytes += column.m_Capacity * rowSize;
+			}
+		}
+
+		stats.m_Components.clear();
+
+		for (const ComponentStats& component : components)
 		{
-			m_Entities[i]->Update();
+			if (component.m_Info) stats.m_Components.push_back(component);
 		}
-			
+
+		stats.m_Tagged.resize(m_Tagged.size());
+
+		for (size_t tag = 0; tag < m_Tagged.size(); ++tag)
+		{
+			stats.m_Tagged[tag] = m_Tagged[tag].size();
+			stats.m_IndexUsedBytes += m_Tagged[tag].size() * sizeof(EntityId);
+			stats.m_IndexReservedBytes += m_Tagged[tag].capacity() * sizeof(EntityId);
+		}
+
+		stats.m_LiveEntities = m_EntityCount;
+		stats.m_PendingDestroy = m_PendingDestroy.size();
+		stats.m_Archetypes = m_Archetypes.size();
+		stats.m_PoolUsedBytes = m_Pool.UsedBytes();
+		stats.m_PoolReservedBytes = m_Pool.ReservedBytes();
+		stats.m_FrameChurn = m_FrameChurn;
+	}
+
+	void Scene::RunPendingStarts()
+	{
+		// Start may add components or create entities, those are appended and started in this same pass
+		for (size_t i = 0; i < m_PendingStarts.size(); ++i)
+		{
+			PendingStart pending = m_PendingStarts[i];
+
+			// The entity may have been killed or lost the component before its first Update
+			if (!IsValid(pending.m_Entity) || m_Records[pending.m_Entity.m_Index].m_Dead) continue;
+
+			const EntityRecord& record = m_Records[pending.m_Entity.m_Index];
+			Column* column = record.m_Archetype->FindColumn(pending.m_Component);
+			if (!column) continue;
+
+			Entity entity(this, pending.m_Entity);
+			column->m_Info->m_Start(column->Get(record.m_Row), entity);
+		}
+
+		m_PendingStarts.clear();
 	}
 }
\ No newline at end of file
@@ -2,87 +2,715 @@
 
 #include <unordered_map>
 #include <vector>
+#include <array>
+#include <bitset>
 #include <memory>
 #include <utility>
+#include <tuple>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <algorithm>
 #include <typeinfo>
 
+#include "Pool.h"
+#include "JobSystem.h"
+
 namespace AF::ECS
 {
 	struct Scene;
 	struct Entity;
 
-	struct Component
+	using ComponentId = uint32_t;
+
+	constexpr size_t MaxComponents = 64;
+	constexpr size_t MaxResources = 32;
+
+	// One bit per ComponentId, describes the exact component set of an archetype
+	using Signature = std::bitset<MaxComponents>;
+
+	// Small user defined category an entity can be looked up by, see Scene::GetTagged. Zero means untagged.
+	using Tag = uint8_t;
+
+	// Index into the scene's entity records plus the generation that record had when the handle was made,
+	// a handle outlives its entity safely as the generation is bumped when the entity is destroyed
+	struct EntityId
 	{
-		Component() = default;
-		virtual ~Component() = default;
+		uint32_t m_Index = ~0u;
+		uint32_t m_Generation = 0;
 
-		virtual void Start();
+		bool operator==(const EntityId& other) const
+		{
+			return m_Index == other.m_Index && m_Generation == other.m_Generation;
+		}
+
+		bool operator!=(const EntityId& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	// Components are plain structs stored by value in their archetype.
+	// A component may optionally provide `void Start(Entity&)`, it is detected at compile time and called
+	// through the type's ComponentInfo at the next Scene::Update after it was added. Per frame logic lives in systems, see Scene::Each.
+	struct ComponentInfo
+	{
+		ComponentId m_Id;
 
-		virtual void Update();
+		// Readable type name for debug views
+		const char* m_Name;
 
-		std::weak_ptr<Entity> m_Entity = {};
+		// Hash of the compiler specific type name, unlike m_Id it is the same across runs of the same build
+		uint64_t m_TypeHash;
+		size_t m_Size;
+		void(*m_Relocate)(void* destination, void* source);
+		void(*m_Copy)(void* destination, const void* source);
+		void(*m_Destroy)(void* data);
+		void(*m_Start)(void* data, Entity& entity);
+		bool m_TriviallyDestructible;
+		bool m_TriviallyCopyable;
 	};
 
-	struct Entity final : public std::enable_shared_from_this<Entity>
+	namespace Detail
 	{
-		Entity(std::weak_ptr<Scene> scene);
+		ComponentId NextComponentId();
+		size_t NextResourceId();
+		void RegisterComponent(const ComponentInfo& info);
+		const ComponentInfo* FindComponentInfo(ComponentId id);
+		const ComponentInfo* FindComponentInfoByHash(uint64_t typeHash);
+		uint64_t HashTypeName(const char* name);
 
-		template<typename t_Type, typename... t_Args>
-		std::shared_ptr<t_Type> CreateComponent(t_Args&&... args)
+		// Turns a typeid name into the name as written in the source, the result lives as long as the program
+		const char* ReadableTypeName(const char* name);
+
+		template<typename t_Type, typename = void>
+		struct HasStart : std::false_type {};
+
+		template<typename t_Type>
+		struct HasStart<t_Type, std::void_t<decltype(std::declval<t_Type&>().Start(std::declval<Entity&>()))>> : std::true_type {};
+	}
+
+	// Dense ids are handed out the first time a type is seen, they are only stable for the lifetime of the process.
+	// `const T` shares the id of T, const access marks read only use, see Scene::Each.
+	template<typename t_Type>
+	ComponentId GetComponentId()
+	{
+		if constexpr (std::is_const_v<t_Type>)
+			return GetComponentId<std::remove_const_t<t_Type>>();
+		else
 		{
-			std::shared_ptr<t_Type> component = std::make_shared<t_Type>(std::forward<t_Args>(args)...);
-			component->m_Entity = weak_from_this();
-			m_Components[typeid(t_Type).hash_code()] = component;
-			//m_Components.insert(std::make_pair(typeid(t_Type).hash_code(), component));
-			return component;
+			static const ComponentId id = Detail::NextComponentId();
+			return id;
 		}
+	}
 
+	namespace Detail
+	{
 		template<typename t_Type>
-		std::shared_ptr<t_Type> GetComponent()
+		size_t GetResourceId()
 		{
-			size_t id = typeid(t_Type).hash_code();
+			static const size_t id = NextResourceId();
+			return id;
+		}
+	}
 
-			auto result = m_Components.find(id);
-			if (result == m_Components.end()) return {};
+	// Query filter for Scene::Each, only visits rows whose T was written during the current or the previous Update.
+	// Use Changed<const T> to observe changes without causing them.
+	template<typename t_Type>
+	struct Changed {};
 
-			return std::dynamic_pointer_cast<t_Type>(result->second);
-		}
+	namespace Detail
+	{
+		template<typename t_Term>
+		struct QueryTerm
+		{
+			using Component = t_Term;
+			static constexpr bool s_Changed = false;
+		};
 
 		template<typename t_Type>
-		std::shared_ptr<t_Type> DestroyComponent()
+		struct QueryTerm<Changed<t_Type>>
 		{
-			size_t id = typeid(t_Type).hash_code();
+			using Component = t_Type;
+			static constexpr bool s_Changed = true;
+		};
 
-			auto result = m_Components.find(id);
-			if (result == m_Components.end()) return {};
+		template<typename t_Term>
+		using QueryComponent = typename QueryTerm<t_Term>::Component;
+	}
 
-			std::shared_ptr<t_Type> component = result->second;
-			component->m_Entity = {};
-			m_Components.remove(id);
+	template<typename... t_Types>
+	Signature MakeSignature()
+	{
+		Signature signature;
+		(signature.set(GetComponentId<t_Types>()), ...);
+		return signature;
+	}
 
-			return component;
+	template<typename t_Type>
+	const ComponentInfo& GetComponentInfo()
+	{
+		static_assert(alignof(t_Type) <= alignof(std::max_align_t), "Over aligned components are not supported");
+
+		static const ComponentInfo info = []()
+		{
+			ComponentInfo result = {};
+			result.m_Id = GetComponentId<t_Type>();
+			result.m_Name = Detail::ReadableTypeName(typeid(t_Type).name());
+			result.m_TypeHash = Detail::HashTypeName(typeid(t_Type).name());
+			result.m_Size = sizeof(t_Type);
+			result.m_TriviallyDestructible = std::is_trivially_destructible_v<t_Type>;
+			result.m_TriviallyCopyable = std::is_trivially_copyable_v<t_Type>;
+
+			result.m_Relocate = [](void* destination, void* source)
+			{
+				new (destination) t_Type(std::move(*static_cast<t_Type*>(source)));
+				static_cast<t_Type*>(source)->~t_Type();
+			};
+
+			result.m_Destroy = [](void* data)
+			{
+				static_cast<t_Type*>(data)->~t_Type();
+			};
+
+			if constexpr (std::is_copy_constructible_v<t_Type>)
+			{
+				result.m_Copy = [](void* destination, const void* source)
+				{
+					new (destination) t_Type(*static_cast<const t_Type*>(source));
+				};
+			}
+
+			if constexpr (Detail::HasStart<t_Type>::value)
+			{
+				result.m_Start = [](void* data, Entity& entity)
+				{
+					static_cast<t_Type*>(data)->Start(entity);
+				};
+			}
+
+			return result;
+		}();
+
+		static const bool registered = (Detail::RegisterComponent(info), true);
+		(void) registered;
+
+		return info;
+	}
+
+	// Contiguous storage for a single component type within an archetype, blocks come from the scene's pool.
+	// Every row also carries the Scene change tick it was last written at.
+	struct Column final
+	{
+		Column(const ComponentInfo* info, BlockPool* pool);
+		Column(Column&& other) noexcept;
+		Column(const Column&) = delete;
+		~Column();
+
+		Column& operator=(const Column&) = delete;
+		Column& operator=(Column&&) = delete;
+
+		void* Get(size_t row)
+		{
+			return m_Data + row * m_Info->m_Size;
 		}
 
-		void Update();
+		void Reserve(size_t capacity, size_t count);
+
+		const ComponentInfo* m_Info;
+		BlockPool* m_Pool;
+		std::byte* m_Data = nullptr;
+		uint32_t* m_Versions = nullptr;
+		size_t m_Capacity = 0;
+	};
+
+	// All entities with the exact same set of components share one archetype,
+	// each component type is stored in its own column indexed by row
+	struct Archetype final
+	{
+		Archetype(Signature signature, BlockPool* pool);
+
+		size_t Size() const
+		{
+			return m_Entities.size();
+		}
+
+		Column* FindColumn(ComponentId id)
+		{
+			int16_t index = m_ColumnIndex[id];
+			return index < 0 ? nullptr : &m_Columns[index];
+		}
 
+		// Grows every column so at least `capacity` rows fit without further allocation
+		void Reserve(size_t capacity);
+		size_t PushRow(EntityId id);
+		EntityId SwapRemove(size_t row);
+		void Clear();
+
+		Signature m_Signature;
+		std::vector<Column> m_Columns;
+		std::array<int16_t, MaxComponents> m_ColumnIndex;
+		std::vector<EntityId> m_Entities;
+		size_t m_Capacity = 0;
+		bool m_TriviallyDestructible = true;
+
+		std::array<Archetype*, MaxComponents> m_AddEdges = {};
+		std::array<Archetype*, MaxComponents> m_RemoveEdges = {};
+	};
+
+	// Describes a component set and the initial value of each component once, see Scene::Instantiate
+	struct Prefab final
+	{
+		struct Prototype
+		{
+			const ComponentInfo* m_Info;
+			std::unique_ptr<std::byte[]> m_Data;
+		};
+
+		Prefab() = default;
+		Prefab(Prefab&&) = default;
+		Prefab(const Prefab&) = delete;
+		~Prefab();
+
+		Prefab& operator=(const Prefab&) = delete;
+
+		// Sets the value new instances start with, replacing any previous value for the type
+		template<typename t_Type, typename... t_Args>
+		Prefab& Add(t_Args&&... args)
+		{
+			static_assert(std::is_copy_constructible_v<t_Type>, "Prefab components must be copy constructible");
+
+			const ComponentInfo& info = GetComponentInfo<t_Type>();
+			void* data = nullptr;
+
+			if (m_Signature.test(info.m_Id))
+			{
+				for (Prototype& prototype : m_Components)
+				{
+					if (prototype.m_Info != &info) continue;
+
+					data = prototype.m_Data.get();
+					info.m_Destroy(data);
+					break;
+				}
+			}
+			else
+			{
+				m_Signature.set(info.m_Id);
+				m_Components.push_back({ &info, std::make_unique<std::byte[]>(info.m_Size) });
+				data = m_Components.back().m_Data.get();
+			}
+
+			new (data) t_Type(std::forward<t_Args>(args)...);
+			return *this;
+		}
+
+		Prefab& SetTag(Tag tag)
+		{
+			m_Tag = tag;
+			return *this;
+		}
+
+		Signature m_Signature;
+		std::vector<Prototype> m_Components;
+		Tag m_Tag = 0;
+	};
+
+	struct EntityRecord
+	{
+		Archetype* m_Archetype = nullptr;
+		uint32_t m_Row = 0;
+		uint32_t m_Generation = 0;
+
+		// Position in the scene's list for m_Tag
+		uint32_t m_TagSlot = 0;
+		Tag m_Tag = 0;
+		bool m_Dead = false;
+	};
+
+	// Non owning handle, all entity storage belongs to the Scene
+	struct Entity final
+	{
+		Entity() = default;
+
+		Entity(Scene* scene, EntityId id)
+			: m_Scene(scene), m_Id(id)
+		{
+		}
+
+		template<typename t_Type, typename... t_Args>
+		t_Type& CreateComponent(t_Args&&... args);
+
+		template<typename t_Type>
+		t_Type* GetComponent();
+
+		template<typename... t_Types>
+		bool HasComponents() const;
+
+		template<typename t_Type>
+		void DestroyComponent();
+
+		void SetTag(Tag tag);
+		Tag GetTag() const;
+
+		bool IsValid() const;
+
+		// Same as Scene::DestroyEntity
 		void Kill();
 
-		std::weak_ptr<Scene> m_Scene;
-		std::unordered_map<size_t, std::shared_ptr<Component>> m_Components;
-		bool m_FirstFrame = true;
+		Scene* m_Scene = nullptr;
+		EntityId m_Id;
+	};
+
+	// Handles are handed out by value in every query, copying one must never touch a refcount
+	static_assert(std::is_trivially_copyable_v<Entity>, "Entity must stay a plain handle");
+
+	// Counts of storage events, the Scene keeps running totals and the difference over the last frame
+	struct SceneChurn
+	{
+		uint64_t m_EntitiesCreated = 0;
+		uint64_t m_EntitiesDestroyed = 0;
+		uint64_t m_BlockAllocations = 0;
+		uint64_t m_BlockFrees = 0;
+	};
+
+	struct ComponentStats
+	{
+		const ComponentInfo* m_Info;
+		size_t m_Count;
+
+		// Column storage including the per row change versions
+		size_t m_UsedBytes;
+		size_t m_ReservedBytes;
+	};
+
+	struct SceneStats
+	{
+		size_t m_LiveEntities = 0;
+		size_t m_PendingDestroy = 0;
+		size_t m_Archetypes = 0;
+
+		// Ordered by component id, types no archetype stores are left out
+		std::vector<ComponentStats> m_Components;
+
+		// Entity count per tag
+		std::vector<size_t> m_Tagged;
+
+		// Records, free list, archetype entity lists and tag lists
+		size_t m_IndexUsedBytes = 0;
+		size_t m_IndexReservedBytes = 0;
+
+		size_t m_PoolUsedBytes = 0;
+		size_t m_PoolReservedBytes = 0;
+
+		SceneChurn m_FrameChurn;
 	};
 
-	struct Scene final : public std::enable_shared_from_this<Scene>
+	struct Scene final
 	{
-		Scene() = default;
+		Scene();
 		~Scene();
 
-		std::shared_ptr<Entity> CreateEntity();
-		std::shared_ptr<Entity> DestroyEntity(std::shared_ptr<Entity> entity);
+		Entity CreateEntity();
+
+		// Marks the entity dead and queues it, the storage is released in bulk by the next Update.
+		// Killing an entity more than once is a no-op. Not synchronised, systems that run alongside others record
+		// their kills in their CommandBuffer instead, it is played back on one thread at the stage barrier.
+		void DestroyEntity(EntityId id);
+
+		bool IsValid(EntityId id) const
+		{
+			return id.m_Index < m_Records.size() && m_Records[id.m_Index].m_Generation == id.m_Generation && m_Records[id.m_Index].m_Archetype;
+		}
+
+		template<typename t_Type, typename... t_Args>
+		t_Type& CreateComponent(EntityId id, t_Args&&... args)
+		{
+			void* data = AddComponent(id, GetComponentInfo<t_Type>());
+			return *new (data) t_Type(std::forward<t_Args>(args)...);
+		}
+
+		// Non const access marks the component as changed, ask for `const T` to only read it
+		template<typename t_Type>
+		t_Type* GetComponent(EntityId id)
+		{
+			if (!IsValid(id)) return nullptr;
+
+			const EntityRecord& record = m_Records[id.m_Index];
+
+			Column* column = record.m_Archetype->FindColumn(GetComponentId<t_Type>());
+			if (!column) return nullptr;
+
+			if constexpr (!std::is_const_v<t_Type>)
+				column->m_Versions[record.m_Row] = m_ChangeTick;
+
+			return static_cast<t_Type*>(column->Get(record.m_Row));
+		}
+
+		template<typename... t_Types>
+		bool HasComponents(EntityId id) const
+		{
+			static const Signature mask = MakeSignature<t_Types...>();
+			return IsValid(id) && (m_Records[id.m_Index].m_Archetype->m_Signature & mask) == mask;
+		}
+
+		template<typename t_Type>
+		void DestroyComponent(EntityId id)
+		{
+			RemoveComponent(id, GetComponentInfo<t_Type>());
+		}
+
+		// Creates `count` copies of the prefab, rows and records for all of them are reserved in one step
+		// and every component is copy constructed from the prefab. Start hooks run on the next Update.
+		Entity Instantiate(const Prefab& prefab);
+		void Instantiate(const Prefab& prefab, size_t count);
+
+		// Same as above, then calls `function(Entity&)` on each new entity to adjust its initial values.
+		// The callback must not add or remove components.
+		template<typename t_Function>
+		void Instantiate(const Prefab& prefab, size_t count, t_Function&& function)
+		{
+			Archetype* archetype;
+			size_t first = InstantiateRows(prefab, count, archetype);
+
+			for (size_t row = first; row < first + count; ++row)
+			{
+				Entity entity(this, archetype->m_Entities[row]);
+				function(entity);
+			}
+		}
+
+		// Tagged entities are kept in one list per tag, updated on tag change and when the entity is released.
+		// Killed entities stay listed until the next Update flushes them.
+		void SetTag(EntityId id, Tag tag);
+
+		Tag GetTag(EntityId id) const
+		{
+			return IsValid(id) ? m_Records[id.m_Index].m_Tag : 0;
+		}
+
+		const std::vector<EntityId>& GetTagged(Tag tag) const
+		{
+			static const std::vector<EntityId> s_Empty;
+			return tag < m_Tagged.size() ? m_Tagged[tag] : s_Empty;
+		}
+
+		void* AddComponent(EntityId id, const ComponentInfo& info);
+		void RemoveComponent(EntityId id, const ComponentInfo& info);
+
+		// Per scene singletons that are not attached to an entity, eg a spatial index. A resource is default constructed
+		// on first use and lives as long as the scene, Clear and snapshots leave it alone.
+		// The first use of a resource must not race with another use of the same resource.
+		template<typename t_Type>
+		t_Type& GetResource()
+		{
+			Resource& resource = m_Resources[Detail::GetResourceId<t_Type>()];
+
+			if (!resource.m_Data)
+			{
+				resource.m_Data = new t_Type();
+				resource.m_Destroy = [](void* data) { delete static_cast<t_Type*>(data); };
+			}
+
+			return *static_cast<t_Type*>(resource.m_Data);
+		}
+
+		// The resource if something already created it, null otherwise
+		template<typename t_Type>
+		const t_Type* FindResource() const
+		{
+			return static_cast<const t_Type*>(m_Resources[Detail::GetResourceId<t_Type>()].m_Data);
+		}
 
+		// Drops every entity. With trivially destructible components this does not touch individual entities,
+		// the archetypes keep their pooled storage for reuse.
 		void Clear();
+
+		// Sync point between frames, advances the change tick, releases killed entities
+		// then starts every component added since the last call
 		void Update();
+		void FlushDestroyed();
+		void RunPendingStarts();
+
+		// Fills `stats` with the current memory use, walks every archetype so it is meant for debug views.
+		// `stats` may be reused across calls to avoid allocating.
+		void GetStats(SceneStats& stats) const;
+		SceneChurn GetChurn() const;
+
+		// Calls `function(t_Types&...)` or `function(Entity&, t_Types&...)` for every entity that has all of t_Types.
+		// The callback must not add or remove components on matching archetypes, entities may still be created
+		// elsewhere or killed as destruction is deferred.
+		// Every visited row of a non const type is marked changed, use `const T` for components that are only read.
+		// A type may be wrapped in Changed<> to skip rows where it wasn't written recently.
+		template<typename... t_Types, typename t_Function>
+		void Each(t_Function&& function)
+		{
+			static const Signature mask = MakeSignature<Detail::QueryComponent<t_Types>...>();
+
+			size_t archetypeCount = m_Archetypes.size();
+
+			for (size_t i = 0; i < archetypeCount; ++i)
+			{
+				Archetype& archetype = *m_Archetypes[i];
+				if ((archetype.m_Signature & mask) != mask) continue;
+
+				EachRows<t_Types...>(archetype, 0, archetype.Size(), function);
+			}
+		}
+
+		// Same contract as Each, but rows are split into fixed chunks of `chunkSize` that run across the job system.
+		// The split only depends on the archetype sizes, so as long as the callback only writes to the entity it was
+		// handed the result is the same as Each. The callback runs on worker threads, so it must not kill entities.
+		template<typename... t_Types, typename t_Function>
+		void ParallelEach(JobSystem& jobs, t_Function&& function, size_t chunkSize = 1024)
+		{
+			static const Signature mask = MakeSignature<Detail::QueryComponent<t_Types>...>();
+
+			struct Chunk
+			{
+				Archetype* m_Archetype;
+				size_t m_Begin;
+				size_t m_End;
+			};
+
+			// Reused so steady state ticks don't allocate. Every call site gets its own list per thread, systems that
+			// run at the same time never share one.
+			static thread_local std::vector<Chunk> s_Chunks;
+			std::vector<Chunk>& chunks = s_Chunks;
+			chunks.clear();
+
+			for (auto& archetype : m_Archetypes)
+			{
+				if ((archetype->m_Signature & mask) != mask) continue;
+
+				for (size_t begin = 0; begin < archetype->Size(); begin += chunkSize)
+					chunks.push_back({ archetype.get(), begin, std::min(begin + chunkSize, archetype->Size()) });
+			}
+
+			auto run = [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					EachRows<t_Types...>(*chunks[i].m_Archetype, chunks[i].m_Begin, chunks[i].m_End, function);
+			};
+
+			// A single captured reference fits in std::function's inline storage
+			jobs.ParallelFor(chunks.size(), 1, [&run](size_t begin, size_t end) { run(begin, end); });
+		}
+
+		template<typename... t_Terms, typename t_Function>
+		void EachRows(Archetype& archetype, size_t begin, size_t end, t_Function& function)
+		{
+			EachRows<t_Terms...>(archetype, begin, end, function, std::index_sequence_for<t_Terms...>());
+		}
+
+		template<typename... t_Terms, typename t_Function, size_t... t_Indices>
+		void EachRows(Archetype& archetype, size_t begin, size_t end, t_Function& function, std::index_sequence<t_Indices...>)
+		{
+			if (begin == end) return;
+
+			constexpr bool filtered = (Detail::QueryTerm<t_Terms>::s_Changed || ...);
+			constexpr bool writes = (!std::is_const_v<Detail::QueryComponent<t_Terms>> || ...);
+
+			std::array<Column*, sizeof...(t_Terms)> columns = { archetype.FindColumn(GetComponentId<Detail::QueryComponent<t_Terms>>())... };
+			std::tuple<Detail::QueryComponent<t_Terms>*...> data = { static_cast<Detail::QueryComponent<t_Terms>*>(static_cast<void*>(columns[t_Indices]->m_Data))... };
+			uint32_t tick = m_ChangeTick;
+
+			for (size_t row = begin; row < end; ++row)
+			{
+				if constexpr (filtered)
+				{
+					if (!((!Detail::QueryTerm<t_Terms>::s_Changed || columns[t_Indices]->m_Versions[row] + 1 >= tick) && ...)) continue;
+				}
 
-		std::vector<std::shared_ptr<Entity>> m_Entities;
+				if constexpr (writes)
+					((std::is_const_v<Detail::QueryComponent<t_Terms>> ? void() : void(columns[t_Indices]->m_Versions[row] = tick)), ...);
+
+				if constexpr (std::is_invocable_v<t_Function, Entity&, Detail::QueryComponent<t_Terms>&...>)
+				{
+					Entity entity(this, archetype.m_Entities[row]);
+					function(entity, std::get<t_Indices>(data)[row]...);
+				}
+				else
+					function(std::get<t_Indices>(data)[row]...);
+			}
+		}
+
+		EntityId NewRecord(Archetype* archetype);
+		size_t InstantiateRows(const Prefab& prefab, size_t count, Archetype*& archetype);
+		Archetype* FindArchetype(Signature signature);
+		void MoveEntity(EntityId id, Archetype* target);
+		void RemoveEntity(EntityId id);
+
+		// Declared first so it outlives the archetypes that allocate from it
+		BlockPool m_Pool;
+
+		std::vector<EntityRecord> m_Records;
+		std::vector<uint32_t> m_FreeIndices;
+		std::vector<EntityId> m_PendingDestroy;
+		std::vector<EntityId> m_DestroyScratch;
+		size_t m_EntityCount = 0;
+
+		uint64_t m_EntitiesCreated = 0;
+		uint64_t m_EntitiesDestroyed = 0;
+
+		// Churn totals at the end of the previous Update and the difference over the frame before that
+		SceneChurn m_FrameStartChurn;
+		SceneChurn m_FrameChurn;
+
+		// Components with a Start hook that were added since the last Update, in the order they were added
+		struct PendingStart
+		{
+			EntityId m_Entity;
+			ComponentId m_Component;
+		};
+
+		std::vector<PendingStart> m_PendingStarts;
+
+		// Advanced by every Update, written components are stamped with it
+		uint32_t m_ChangeTick = 1;
+
+		// Indexed by Tag, the untagged list is always empty
+		std::vector<std::vector<EntityId>> m_Tagged;
+
+		// New records start at this generation, Clear and LoadSnapshot raise it past every handle given out so far
+		uint32_t m_GenerationBase = 0;
+		uint32_t m_NextGeneration = 0;
+
+		struct Resource
+		{
+			void* m_Data = nullptr;
+			void(*m_Destroy)(void* data) = nullptr;
+		};
+
+		std::array<Resource, MaxResources> m_Resources;
+
+		std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+		std::unordered_map<Signature, Archetype*> m_ArchetypeLookup;
+		Archetype* m_EmptyArchetype = nullptr;
 	};
+
+	template<typename t_Type, typename... t_Args>
+	t_Type& Entity::CreateComponent(t_Args&&... args)
+	{
+		return m_Scene->CreateComponent<t_Type>(m_Id, std::forward<t_Args>(args)...);
+	}
+
+	template<typename t_Type>
+	t_Type* Entity::GetComponent()
+	{
+		return m_Scene ? m_Scene->GetComponent<t_Type>(m_Id) : nullptr;
+	}
+
+	template<typename... t_Types>
+	bool Entity::HasComponents() const
+	{
+		return m_Scene && m_Scene->HasComponents<t_Types...>(m_Id);
+	}
+
+	template<typename t_Type>
+	void Entity::DestroyComponent()
+	{
+		if (m_Scene) m_Scene->DestroyComponent<t_Type>(m_Id);
+	}
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "Application.h"
 #include "Log.h"
 
-#define AF_MAIN() int main(int, char**)
+#define AF_MAIN() int main(int argc, char** argv)
 #if defined(AF_PLAT_WINDOWS) && defined(AF_CONF_DIST)
 #	undef AF_MAIN
 #	define AF_MAIN() int WINAPI wWinMain(HINSTANCE, HINSTANCE, PWSTR, int)
@@ -24,6 +24,12 @@ AF_MAIN()
 	AF_INFO("Started");
 
 	AF::s_Application = AF::CreateApplication();
+
+#if !defined(AF_PLAT_WINDOWS) || !defined(AF_CONF_DIST)
+	for (int i = 1; i < argc; ++i)
+		AF::s_Application->m_Arguments.push_back(argv[i]);
+#endif
+
 	AF::s_Application->Start();
 	delete AF::s_Application;
 	AF::s_Application = nullptr;
@@ -1,5 +1,6 @@
 #include <memory>
 #include <array>
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <typeinfo>
@@ -7,540 +8,523 @@
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
-#include <glm/gtc/random.hpp>
 
 #include "Debugger.h"
 #include "Log.h"
 #include "Application.h"
 #include "Timer.h"
 #include "ECS.h"
+#include "Scheduler.h"
+#include "Snapshot.h"
+#include "Components.h"
+#include "Prefabs.h"
+#include "SpatialGrid.h"
+#include "SweepAndPrune.h"
+#include "AABB.h"
+#include "TrailParticles.h"
 
-struct EntityTag : public AF::ECS::Component
+class MenuState : public AF::State
 {
-	enum EntityTagType : uint8_t
+public:
+	struct Button
 	{
-		NONE = 0, PLAYER, ENEMY, TRAIL
+		const char* name;
+		void(*onClick)();
 	};
 
-	EntityTag(EntityTagType type = NONE)
-		: m_Type(type)
-	{
-	}
-
-	virtual ~EntityTag() = default;
-	
-	EntityTagType m_Type;
-};
-
-struct Transform : public AF::ECS::Component
-{
-	Transform(glm::vec2 position = { 0.0f, 0.0f }, glm::vec2 size = { 32.0f, 32.0f })
-		: m_Position(position), m_Size(size)
-	{
-	}
-
-	virtual ~Transform() = default;
+	int selectedOption = 1;
 
-	bool IntersectsWith(std::shared_ptr<Transform> other)
-	{
-		glm::vec4 a = { m_Position, m_Size };
-		glm::vec4 b = { other->m_Position, other->m_Size };
+	virtual void FixedUpdate();
+	virtual void Update();
+	virtual void Attach();
+	virtual void Detach();
 
-		return (glm::abs((a.x + a.z / 2.0f) - (b.x + b.z / 2.0f)) * 2.0f < (a.z + b.z)) && (glm::abs((a.y + a.w / 2.0f) - (b.y + b.w / 2.0f)) * 2.0f < (a.w + b.w));
-	}
+	std::shared_ptr<AF::ECS::Scene> m_Scene = std::make_shared<AF::ECS::Scene>();
 
-	glm::vec2 m_Position;
-	glm::vec2 m_Size;
+	AF::Timer<float> m_Timer = AF::Timer<float>(0.12f);
+	AF::Timer<float> m_FadeTimer = AF::Timer<float>(0.5f, true);
 };
 
-struct BoxRenderer : public AF::ECS::Component
+// Switches from the state that lost to the one that follows it, defined after GameState.
+// Only the first call for a state does anything, a frame that runs several ticks can lose more than once.
+static void GameOver(const std::weak_ptr<AF::State>& lost);
+
+glm::vec2 GetWorldSize()
 {
-	BoxRenderer(glm::vec4 color = { 1.0f, 1.0f, 1.0f, 1.0f })
-		: m_Color(color)
-	{
-	}
+	return AF::GetApplication()->m_ReferenceSize;
+}
 
-	virtual ~BoxRenderer() = default;
+void PlayerInputSystem(AF::ECS::Scene& scene)
+{
+	auto* app = AF::GetApplication();
 
-	virtual void Update() override
+	scene.Each<const PlayerControlled, RigidBody>([app](const PlayerControlled&, RigidBody& rigidBody)
 	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
-		{
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
+		rigidBody.m_Velocity = { 0.0f, 0.0f };
 
-			if (transform)
-			{
-				auto* app = AF::GetApplication();
-				app->m_Renderer.VGRP_FillRect(transform->m_Position, transform->m_Size, m_Color);
-			}
-		}
-	}
+		if (app->m_Keys.find(GLFW_KEY_A) != app->m_Keys.end()) --rigidBody.m_Velocity.x;
+		if (app->m_Keys.find(GLFW_KEY_D) != app->m_Keys.end()) ++rigidBody.m_Velocity.x;
+		if (app->m_Keys.find(GLFW_KEY_W) != app->m_Keys.end()) --rigidBody.m_Velocity.y;
+		if (app->m_Keys.find(GLFW_KEY_S) != app->m_Keys.end()) ++rigidBody.m_Velocity.y;
 
-	glm::vec4 m_Color;
-};
+		rigidBody.m_Velocity *= 500.0f;
+	});
+}
 
-struct RigidBody : public AF::ECS::Component
+void MovementSystem(AF::ECS::Scene& scene)
 {
-	RigidBody(glm::vec2 velocity = { 0.0f, 0.0f })
-		: m_Velocity(velocity)
-	{
-	}
-
-	virtual ~RigidBody() = default;
+	auto* app = AF::GetApplication();
+	float deltaTime = static_cast<float>(app->m_FixedDeltaTime);
 
-	virtual void Update() override
+	scene.ParallelEach<const RigidBody, Transform>(app->m_JobSystem, [deltaTime](const RigidBody& rigidBody, Transform& transform)
 	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
-		{
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
+		// Rendering blends from here, anything that moves the entity later in the tick is part of the step
+		transform.m_PreviousPosition = transform.m_Position;
+		transform.m_Position += rigidBody.m_Velocity * deltaTime;
+	});
+}
 
-			if (transform)
-			{
-				auto* app = AF::GetApplication();
-				transform->m_Position += m_Velocity * static_cast<float>(app->m_DeltaTime);
-			}
-		}
-	}
+// Separates two overlapping boxes along the axis they overlap least on and bounces them off each other elastically,
+// heavier meaning larger
+static void ResolveCollision(Transform& a, RigidBody& bodyA, Transform& b, RigidBody& bodyB)
+{
+	glm::vec2 delta = (b.m_Position + b.m_Size * 0.5f) - (a.m_Position + a.m_Size * 0.5f);
+	glm::vec2 overlap = (a.m_Size + b.m_Size) * 0.5f - glm::abs(delta);
 
-	glm::vec2 m_Velocity;
-};
+	// An earlier pair this tick may have pushed them apart already
+	if (overlap.x <= 0.0f || overlap.y <= 0.0f) return;
 
-struct Fader : public AF::ECS::Component
-{
-	Fader(float timerDuration = 0.2f)
-		: m_Timer(timerDuration, true)
-	{
-	}
+	int axis = overlap.x < overlap.y ? 0 : 1;
+	float normal = delta[axis] < 0.0f ? -1.0f : 1.0f;
 
-	virtual ~Fader() = default;
+	float massA = a.m_Size.x * a.m_Size.y;
+	float massB = b.m_Size.x * b.m_Size.y;
+	float totalMass = massA + massB;
 
-	virtual void Update() override
-	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
-		{
-			std::shared_ptr<BoxRenderer> boxRenderer = entity->GetComponent<BoxRenderer>();
+	a.m_Position[axis] -= normal * overlap[axis] * massB / totalMass;
+	b.m_Position[axis] += normal * overlap[axis] * massA / totalMass;
 
-			if (boxRenderer)
-			{
-				auto* app = AF::GetApplication();
+	float velocityA = bodyA.m_Velocity[axis];
+	float velocityB = bodyB.m_Velocity[axis];
 
-				if (m_Timer.Update(static_cast<float>(app->m_DeltaTime))) entity->Kill();
-				boxRenderer->m_Color.a = 1.0f - m_Timer.PercentComplete();
-			}
-		}
-	}
+	// Already moving apart
+	if ((velocityB - velocityA) * normal >= 0.0f) return;
 
-	AF::Timer<float> m_Timer;
-};
+	bodyA.m_Velocity[axis] = ((massA - massB) * velocityA + 2.0f * massB * velocityB) / totalMass;
+	bodyB.m_Velocity[axis] = ((massB - massA) * velocityB + 2.0f * massA * velocityA) / totalMass;
+}
 
-struct EdgeSpawner : public AF::ECS::Component
+void EnemyCollisionSystem(AF::ECS::Scene& scene)
 {
-	EdgeSpawner() = default;
-	virtual ~EdgeSpawner() = default;
+	static std::vector<AF::SweepAndPrune::Pair> s_Pairs;
 
-	virtual void Start() override
-	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
-		{
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
-			std::shared_ptr<RigidBody> rigidBody = entity->GetComponent<RigidBody>();
+	AF::SweepAndPrune& broadPhase = scene.GetResource<AF::SweepAndPrune>();
 
-			if (transform && rigidBody)
-			{
-				auto* app = AF::GetApplication();
+	// Resolving a pair needs both components. Entries that stopped being enemies with a body since an earlier tick
+	// are dropped the same way dead ones are, so every pair found below has them.
+	auto tracked = [&scene](AF::ECS::EntityId id)
+	{
+		return scene.IsValid(id) && scene.GetTag(id) == EntityTag::ENEMY && scene.HasComponents<Transform, RigidBody>(id);
+	};
 
-				int direction = glm::linearRand<int>(0, 3);
-				float speed = glm::linearRand<float>(300.0f, 600.0f);
+	broadPhase.RemoveIf([&tracked](AF::ECS::EntityId id)
+	{
+		return !tracked(id);
+	});
 
-				transform->m_Position.x = glm::linearRand<float>(-transform->m_Size.x, app->m_ReferenceSize.x);
-				transform->m_Position.y = glm::linearRand<float>(-transform->m_Size.y, app->m_ReferenceSize.y);
+	for (AF::ECS::EntityId enemy : scene.GetTagged(EntityTag::ENEMY))
+	{
+		if (!tracked(enemy)) continue;
 
-				switch (direction)
-				{
-					case 0:
-						rigidBody->m_Velocity = { 0, 1 };
-						transform->m_Position.y = -transform->m_Size.y;
-						break;
-					case 1:
-						rigidBody->m_Velocity = { 0, -1 };
-						transform->m_Position.y = app->m_ReferenceSize.y;
-						break;
-					case 2:
-						rigidBody->m_Velocity = { 1, 0 };
-						transform->m_Position.x = -transform->m_Size.x;
-						break;
-					case 3:
-						rigidBody->m_Velocity = { -1, 0 };
-						transform->m_Position.x = app->m_ReferenceSize.x;
-						break;
-				}
-
-				rigidBody->m_Velocity *= speed;
-			}
-		}
+		const Transform* transform = scene.GetComponent<const Transform>(enemy);
+		broadPhase.Set(enemy, transform->m_Position, transform->m_Position + transform->m_Size);
 	}
-};
 
-struct Flasher : public AF::ECS::Component
+	s_Pairs.clear();
+	broadPhase.FindOverlaps(s_Pairs);
+
+	for (const auto& [a, b] : s_Pairs)
+		ResolveCollision(*scene.GetComponent<Transform>(a), *scene.GetComponent<RigidBody>(a), *scene.GetComponent<Transform>(b), *scene.GetComponent<RigidBody>(b));
+}
+
+void EdgeSystem(AF::ECS::Scene& scene, AF::ECS::CommandBuffer& commands)
 {
-	Flasher() = default;
-	virtual ~Flasher() = default;
+	auto* app = AF::GetApplication();
+	glm::vec2 bounds = app->m_ReferenceSize;
 
-	virtual void Update() override
+	scene.ParallelEach<const EdgeBouncer, RigidBody, Transform>(app->m_JobSystem, [bounds](const EdgeBouncer&, RigidBody& rigidBody, Transform& transform)
 	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
+		if (transform.m_Position.x + transform.m_Size.x > bounds.x)
 		{
-			std::shared_ptr<BoxRenderer> boxRenderer = entity->GetComponent<BoxRenderer>();
+			transform.m_Position.x = bounds.x - transform.m_Size.x;
+			rigidBody.m_Velocity.x *= -1.0f;
+		}
 
-			if (boxRenderer)
-			{
-				boxRenderer->m_Color.r = glm::linearRand<float>(0.0f, 1.0f);
-				boxRenderer->m_Color.g = glm::linearRand<float>(0.0f, 1.0f);
-				boxRenderer->m_Color.b = glm::linearRand<float>(0.0f, 1.0f);
-			}
+		if (transform.m_Position.y + transform.m_Size.y > bounds.y)
+		{
+			transform.m_Position.y = bounds.y - transform.m_Size.y;
+			rigidBody.m_Velocity.y *= -1.0f;
 		}
-	}
-};
 
-struct EdgeKiller : public AF::ECS::Component
-{
-	EdgeKiller() = default;
-	virtual ~EdgeKiller() = default;
+		if (transform.m_Position.x < 0.0f)
+		{
+			transform.m_Position.x = 0.0f;
+			rigidBody.m_Velocity.x *= -1.0f;
+		}
 
-	virtual void Update() override
-	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
+		if (transform.m_Position.y < 0.0f)
 		{
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
+			transform.m_Position.y = 0.0f;
+			rigidBody.m_Velocity.y *= -1.0f;
+		}
+	});
 
-			if (transform)
-			{
-				auto* app = AF::GetApplication();
+	scene.Each<const EdgeClamper, Transform>([bounds](const EdgeClamper&, Transform& transform)
+	{
+		transform.m_Position.x = glm::clamp(transform.m_Position.x, 0.0f, bounds.x - transform.m_Size.x);
+		transform.m_Position.y = glm::clamp(transform.m_Position.y, 0.0f, bounds.y - transform.m_Size.y);
+	});
 
-				bool shouldDie = false;
+	// Recorded like any structural change made by a system, the kills land at the stage barrier
+	scene.Each<const EdgeKiller, const Transform>([bounds, &commands](AF::ECS::Entity& entity, const EdgeKiller&, const Transform& transform)
+	{
+		bool shouldDie = false;
 
-				if (transform->m_Position.x > app->m_ReferenceSize.x + transform->m_Size.x * 2.0f) shouldDie = true;
-				if (transform->m_Position.y > app->m_ReferenceSize.y + transform->m_Size.y * 2.0f) shouldDie = true;
-				if (transform->m_Position.x < -transform->m_Size.x * 2.0f) shouldDie = true;
-				if (transform->m_Position.y < -transform->m_Size.y * 2.0f) shouldDie = true;
+		if (transform.m_Position.x > bounds.x + transform.m_Size.x * 2.0f) shouldDie = true;
+		if (transform.m_Position.y > bounds.y + transform.m_Size.y * 2.0f) shouldDie = true;
+		if (transform.m_Position.x < -transform.m_Size.x * 2.0f) shouldDie = true;
+		if (transform.m_Position.y < -transform.m_Size.y * 2.0f) shouldDie = true;
 
-				if (shouldDie) entity->Kill();
-			}
-		}
-	}
-};
+		if (shouldDie) commands.DestroyEntity(entity.m_Id);
+	});
+}
 
-struct TrailSpawner : public AF::ECS::Component
+void TrailSystem(AF::ECS::Scene& scene)
 {
-	TrailSpawner(float timerLenth = 0.01f)
-		: m_Timer(timerLenth)
-	{
-	}
+	float deltaTime = static_cast<float>(AF::GetApplication()->m_FixedDeltaTime);
+	AF::TrailParticles& trails = scene.GetResource<AF::TrailParticles>();
 
-	virtual ~TrailSpawner() = default;
+	trails.Update(deltaTime);
 
-	virtual void Update() override
+	scene.Each<TrailSpawner, const Transform, const BoxRenderer>([deltaTime, &trails](TrailSpawner& trailSpawner, const Transform& transform, const BoxRenderer& boxRenderer)
 	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
-		{
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
-			std::shared_ptr<BoxRenderer> boxRenderer = entity->GetComponent<BoxRenderer>();
+		if (trailSpawner.m_Timer.Update(deltaTime))
+			trails.Emit(transform.m_Position, transform.m_Size, boxRenderer.m_Color);
+	});
+}
 
-			if (transform && boxRenderer)
-			{
-				auto* app = AF::GetApplication();
+void FlasherSystem(AF::ECS::Scene& scene)
+{
+	// Colors are drawn in batches for 64 entities at a time, numbers left over at the end are dropped
+	static std::array<float, 3 * 64> s_Channels;
 
-				if (m_Timer.Update(static_cast<float>(app->m_DeltaTime)))
-				{
+	AF::Random& random = scene.GetResource<AF::RandomStreams>().Get(RandomStream::FLASHER);
+	size_t next = s_Channels.size();
 
-					if (std::shared_ptr<AF::ECS::Scene> scene = entity->m_Scene.lock())
-					{
-						std::shared_ptr<AF::ECS::Entity> newEntity = scene->CreateEntity();
-						newEntity->CreateComponent<EntityTag>(EntityTag::TRAIL);
-						newEntity->CreateComponent<BoxRenderer>(boxRenderer->m_Color);
-						newEntity->CreateComponent<Fader>();
-						newEntity->CreateComponent<Transform>(transform->m_Position, transform->m_Size);
-					}
-				}
-			}
+	scene.Each<const Flasher, BoxRenderer>([&random, &next](const Flasher&, BoxRenderer& boxRenderer)
+	{
+		if (next == s_Channels.size())
+		{
+			random.Fill(s_Channels.data(), s_Channels.size(), 0.0f, 1.0f);
+			next = 0;
 		}
-	}
 
-	AF::Timer<float> m_Timer;
-};
+		boxRenderer.m_Color.r = s_Channels[next++];
+		boxRenderer.m_Color.g = s_Channels[next++];
+		boxRenderer.m_Color.b = s_Channels[next++];
+	});
+}
 
-struct EdgeBouncer : public AF::ECS::Component
+// Keeps the enemy grid in step with the enemies' transforms, an enemy is only relinked when it moved to other cells
+void SpatialIndexSystem(AF::ECS::Scene& scene)
 {
-	EdgeBouncer() = default;
-	virtual ~EdgeBouncer() = default;
+	constexpr float cellSize = 64.0f;
 
-	virtual void Update() override
-	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
-		{
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
-			std::shared_ptr<RigidBody> rigidBody = entity->GetComponent<RigidBody>();
+	AF::SpatialGrid& grid = scene.GetResource<AF::SpatialGrid>();
 
-			if (transform && rigidBody)
-			{
-				auto* app = AF::GetApplication();
+	if (grid.GetWorldSize() != GetWorldSize())
+		grid.Reset(GetWorldSize(), cellSize);
 
-				if (transform->m_Position.x + transform->m_Size.x > app->m_ReferenceSize.x)
-				{
-					transform->m_Position.x = app->m_ReferenceSize.x - transform->m_Size.x;
-					rigidBody->m_Velocity.x *= -1.0f;
-				}
+	// Entries that stopped being enemies with a Transform are dropped the same way dead ones are,
+	// PlayerHealthSystem would otherwise keep testing the player against them
+	auto tracked = [&scene](AF::ECS::EntityId id)
+	{
+		return scene.IsValid(id) && scene.GetTag(id) == EntityTag::ENEMY && scene.HasComponents<Transform>(id);
+	};
 
-				if (transform->m_Position.y + transform->m_Size.y > app->m_ReferenceSize.y)
-				{
-					transform->m_Position.y = app->m_ReferenceSize.y - transform->m_Size.y;
-					rigidBody->m_Velocity.y *= -1.0f;
-				}
+	grid.RemoveIf([&tracked](AF::ECS::EntityId id)
+	{
+		return !tracked(id);
+	});
 
-				if (transform->m_Position.x < 0.0f)
-				{
-					transform->m_Position.x = 0.0f;
-					rigidBody->m_Velocity.x *= -1.0f;
-				}
+	for (AF::ECS::EntityId enemy : scene.GetTagged(EntityTag::ENEMY))
+	{
+		if (!tracked(enemy)) continue;
 
-				if (transform->m_Position.y < 0.0f)
-				{
-					transform->m_Position.y = 0.0f;
-					rigidBody->m_Velocity.y *= -1.0f;
-				}
-			}
-		}
+		const Transform* transform = scene.GetComponent<const Transform>(enemy);
+		grid.Set(enemy, transform->m_Position, transform->m_Position + transform->m_Size);
 	}
-};
+}
 
-struct EdgeClamper : public AF::ECS::Component
+void PlayerHealthSystem(AF::ECS::Scene& scene)
 {
-	EdgeClamper() = default;
-	virtual ~EdgeClamper() = default;
+	auto* app = AF::GetApplication();
 
-	virtual void Update() override
-	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
-		{
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
-			auto* app = AF::GetApplication();
+	const AF::SpatialGrid& grid = scene.GetResource<AF::SpatialGrid>();
 
-			transform->m_Position.x = glm::clamp(transform->m_Position.x, 0.0f, app->m_ReferenceSize.x - transform->m_Size.x);
-			transform->m_Position.y = glm::clamp(transform->m_Position.y, 0.0f, app->m_ReferenceSize.y - transform->m_Size.y);
-		}
-	}
-};
+	static std::vector<AF::ECS::EntityId> s_Enemies;
+	static AF::AABBBatch s_Boxes;
+	static std::vector<uint64_t> s_Hits;
 
-struct RandomSpawner : public AF::ECS::Component
-{
-	RandomSpawner(glm::vec2 speedRange = { 100.0f, 500.0f })
-		: m_SpeedRange(speedRange)
+	scene.Each<PlayerControlled, const Transform>([app, &scene, &grid](PlayerControlled& player, const Transform& transform)
 	{
-	}
+		glm::vec2 min = transform.m_Position;
+		glm::vec2 max = transform.m_Position + transform.m_Size;
 
-	virtual ~RandomSpawner() = default;
+		s_Enemies.clear();
+		grid.QueryAABB(min, max, s_Enemies);
 
-	virtual void Start() override
-	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
+		// The grid answers from the boxes it was last given, the current transforms decide the actual hits
+		s_Boxes.Clear();
+
+		for (AF::ECS::EntityId enemy : s_Enemies)
 		{
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
-			std::shared_ptr<RigidBody> rigidBody = entity->GetComponent<RigidBody>();
+			if (const Transform* other = scene.GetComponent<const Transform>(enemy))
+				s_Boxes.Push(other->m_Position, other->m_Position + other->m_Size);
+		}
 
-			if (transform && rigidBody)
-			{
-				auto* app = AF::GetApplication();
+		AF::OverlapAABB(min, max, s_Boxes, s_Hits);
 
-				do
-				{
-					rigidBody->m_Velocity.x = glm::linearRand<float>(-m_SpeedRange[1], m_SpeedRange[1]);
-					rigidBody->m_Velocity.y = glm::linearRand<float>(-m_SpeedRange[1], m_SpeedRange[1]);
-				}
-				while (glm::length(rigidBody->m_Velocity) < m_SpeedRange[0]);
+		for (size_t i = 0; i < s_Boxes.Size(); ++i)
+		{
+			if (s_Hits[i / 64] & (uint64_t(1) << (i % 64)))
+				player.m_CurrentHealth -= ((s_Boxes.m_MaxX[i] - s_Boxes.m_MinX[i]) * 3.0f) * app->m_FixedDeltaTime;
+		}
 
-				transform->m_Position.x = glm::linearRand<float>(0.0f, app->m_ReferenceSize.x - transform->m_Size.x);
-				transform->m_Position.y = glm::linearRand<float>(0.0f, app->m_ReferenceSize.y - transform->m_Size.y);
-			}
+		if (player.m_CurrentHealth <= 0.0f)
+		{
+			app->InvokeLater([lost = std::weak_ptr<AF::State>(app->m_StateManager.GetState())]()
+			{
+				GameOver(lost);
+			});
 		}
-	}
 
-	glm::vec2 m_SpeedRange;
-};
+		player.m_CurrentHealth += app->m_FixedDeltaTime * 5.0f;
+		player.m_CurrentHealth = glm::clamp(player.m_CurrentHealth, 0.0f, player.m_MaxHealth);
+	});
+}
 
-struct CenterSpawner : public AF::ECS::Component
+void RenderSystem(AF::ECS::Scene& scene)
 {
-	CenterSpawner() = default;
-	virtual ~CenterSpawner() = default;
+	auto* app = AF::GetApplication();
+	float alpha = app->m_Interpolation;
+
+	// Trails go underneath whatever left them
+	scene.GetResource<AF::TrailParticles>().Draw(app->m_Renderer);
 
-	virtual void Start() override
+	scene.Each<const BoxRenderer, const Transform>([app, alpha](const BoxRenderer& boxRenderer, const Transform& transform)
 	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
-		{
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
-			auto* app = AF::GetApplication();
+		app->m_Renderer.VGRP_FillRect(transform.Interpolate(alpha), transform.m_Size, boxRenderer.m_Color);
+	});
 
-			if (transform)
-			{
-				transform->m_Position = (app->m_ReferenceSize - transform->m_Size) / 2.0f;	
-			}
-		}
-	}
+	scene.Each<const PlayerControlled, const Transform>([app, alpha](const PlayerControlled& player, const Transform& transform)
+	{
+		float width = 200.0f;
+		float healthWidth = player.m_CurrentHealth / player.m_MaxHealth * width;
+		glm::vec2 position = transform.Interpolate(alpha);
+
+		app->m_Renderer.VGRP_FillRect(position + glm::vec2{ 100.0f + healthWidth, 100.0f }, { width - healthWidth, 20.0f }, { 1.0f, 1.0f, 1.0f, 0.5f });
+		app->m_Renderer.VGRP_FillRect(position + glm::vec2{ 100.0f, 100.0f }, { healthWidth, 20.0f }, { 1.0f, 0.0f, 0.0f, 0.75f });
+	});
+}
+
+// Set between ticks to have SplitSystem split every enemy on the next one
+struct EnemySplitRequest
+{
+	bool m_Pending = false;
 };
 
-class MenuState : public AF::State
+// Replaces every enemy with four half sized pieces that keep most of its velocity
+void SplitEnemies(AF::ECS::Scene& scene)
 {
-public:
-	struct Button
+	struct SplitSource
 	{
-		const char* name;
-		void(*onClick)();
+		Transform m_Transform;
+		RigidBody m_RigidBody;
 	};
 
-	int selectedOption = 1;
+	// Gathered first, the new pieces are tagged as enemies too
+	std::vector<SplitSource> sources;
 
-	virtual void Update();
-	virtual void Attach();
-	virtual void Detach();
+	for (AF::ECS::EntityId enemy : scene.GetTagged(EntityTag::ENEMY))
+	{
+		const Transform* transform = scene.GetComponent<const Transform>(enemy);
+		const RigidBody* rigidBody = scene.GetComponent<const RigidBody>(enemy);
+		if (!transform || !rigidBody) continue;
 
-	std::shared_ptr<AF::ECS::Scene> m_Scene = std::make_shared<AF::ECS::Scene>();
+		sources.push_back({ *transform, *rigidBody });
+		scene.DestroyEntity(enemy);
+	}
 
-	AF::Timer<float> m_Timer = AF::Timer<float>(0.12f);
-	AF::Timer<float> m_FadeTimer = AF::Timer<float>(0.5f, true);
-};
+	static const std::array<glm::vec2, 4> s_Offsets = { glm::vec2{ 0.0f, 0.0f }, glm::vec2{ 0.0f, 0.25f }, glm::vec2{ 0.25f, 0.0f }, glm::vec2{ 0.25f, 0.25f } };
 
-struct PlayerControlled : public AF::ECS::Component
-{
-	PlayerControlled() = default;
-	virtual ~PlayerControlled() = default;
+	AF::Random& random = scene.GetResource<AF::RandomStreams>().Get(RandomStream::SPLIT);
 
-	virtual void Update() override
+	for (const SplitSource& source : sources)
 	{
-		if (std::shared_ptr<AF::ECS::Entity> entity = m_Entity.lock())
+		size_t piece = 0;
+
+		scene.Instantiate(GetSplitEnemyPrefab(), s_Offsets.size(), [&source, &piece, &random](AF::ECS::Entity& entity)
 		{
-			std::shared_ptr<RigidBody> rigidBody = entity->GetComponent<RigidBody>();
-			std::shared_ptr<Transform> transform = entity->GetComponent<Transform>();
+			Transform* transform = entity.GetComponent<Transform>();
+			RigidBody* rigidBody = entity.GetComponent<RigidBody>();
 
-			if (rigidBody)
-			{
-				auto* app = AF::GetApplication();
+			float min = 32.0f;
 
-				rigidBody->m_Velocity = { 0.0f, 0.0f };
+			transform->m_Size = source.m_Transform.m_Size * 0.5f;
+			transform->m_Position = source.m_Transform.m_Position + source.m_Transform.m_Size * s_Offsets[piece++];
+			rigidBody->m_Velocity = source.m_RigidBody.m_Velocity * 0.8f + glm::vec2{ random.Float(-min, min), random.Float(-min, min) };
+		});
+	}
+}
 
-				if (app->m_Keys.find(GLFW_KEY_A) != app->m_Keys.end()) --rigidBody->m_Velocity.x;
-				if (app->m_Keys.find(GLFW_KEY_D) != app->m_Keys.end()) ++rigidBody->m_Velocity.x;
-				if (app->m_Keys.find(GLFW_KEY_W) != app->m_Keys.end()) --rigidBody->m_Velocity.y;
-				if (app->m_Keys.find(GLFW_KEY_S) != app->m_Keys.end()) ++rigidBody->m_Velocity.y;
+// Structural changes are made directly, the kills are flushed so the split enemies are gone for the rest of the tick
+void SplitSystem(AF::ECS::Scene& scene)
+{
+	EnemySplitRequest& request = scene.GetResource<EnemySplitRequest>();
+	if (!request.m_Pending) return;
 
-				rigidBody->m_Velocity *= 500.0f;
-			}
+	request.m_Pending = false;
+	SplitEnemies(scene);
+	scene.FlushDestroyed();
+}
 
-			std::shared_ptr<AF::ECS::Scene> scene = entity->m_Scene.lock();
+AF::ECS::Scheduler CreateScheduler()
+{
+	using namespace AF::ECS;
+
+	Scheduler scheduler;
+	scheduler.Add<>("Split", SplitSystem, System::EXCLUSIVE);
+	scheduler.Add<Read<PlayerControlled>, Write<RigidBody>>("PlayerInput", PlayerInputSystem);
+	scheduler.Add<Read<RigidBody>, Write<Transform>>("Movement", MovementSystem);
+	scheduler.Add<Write<Transform, RigidBody, AF::SweepAndPrune>>("EnemyCollision", EnemyCollisionSystem);
+	scheduler.Add<Read<Flasher>, Write<BoxRenderer>>("Flasher", FlasherSystem);
+	scheduler.Add<Read<EdgeBouncer, EdgeClamper, EdgeKiller>, Write<Transform, RigidBody>>("Edge", EdgeSystem);
+	scheduler.Add<Read<Transform>, Write<AF::SpatialGrid>>("SpatialIndex", SpatialIndexSystem);
+	scheduler.Add<Read<Transform, AF::SpatialGrid>, Write<PlayerControlled>>("PlayerHealth", PlayerHealthSystem);
+	scheduler.Add<Read<Transform, BoxRenderer>, Write<TrailSpawner, AF::TrailParticles>>("Trail", TrailSystem);
+	return scheduler;
+}
 
-			if (scene && transform)
-			{
+// Advances the scene by one simulation tick
+void TickScene(AF::ECS::Scene& scene)
+{
+	static AF::ECS::Scheduler s_Scheduler = CreateScheduler();
 
-				auto* app = AF::GetApplication();
+	scene.Update();
+	s_Scheduler.Run(scene, AF::GetApplication()->m_JobSystem);
+}
 
-				for (auto other : scene->m_Entities)
-				{
-					auto tag = other->GetComponent<EntityTag>();
-
-					if (tag && tag->m_Type == EntityTag::ENEMY)
-					{
-						if (transform->IntersectsWith(other->GetComponent<Transform>()))
-						{
-							m_CurrentHealth -= (other->GetComponent<Transform>()->m_Size.x * 3.0f) * app->m_DeltaTime;
-						}
-					}
-				}
-
-				if (m_CurrentHealth <= 0.0f)
-				{
-					app->InvokeLater([]()
-					{
-						AF::GetApplication()->m_StateManager.SetState(std::make_shared<MenuState>());
-					});
-				}
+// Draws the scene between its last two ticks, must be called inside a renderer frame
+void RenderScene(AF::ECS::Scene& scene)
+{
+	RenderSystem(scene);
+}
 
-				m_CurrentHealth += app->m_DeltaTime * 5.0f;
-				m_CurrentHealth = glm::clamp(m_CurrentHealth, 0.0f, m_MaxHealth);
+// Every scene gets its own seed from the application's generator, a run started with the same seed replays exactly
+void SeedScene(AF::ECS::Scene& scene)
+{
+	AF::Random& random = AF::GetApplication()->m_Random;
 
-				float width = 200.0f;
-				float healthWidth = m_CurrentHealth / m_MaxHealth * width;
+	uint64_t seed = static_cast<uint64_t>(random.Next()) << 32;
+	seed |= random.Next();
 
-				app->m_Renderer.VGRP_FillRect(transform->m_Position + glm::vec2{ 100.0f + healthWidth, 100.0f }, { width - healthWidth, 20.0f }, { 1.0f, 1.0f, 1.0f, 0.5f });
-				app->m_Renderer.VGRP_FillRect(transform->m_Position + glm::vec2{ 100.0f, 100.0f }, { healthWidth, 20.0f }, { 1.0f, 0.0f, 0.0f, 0.75f });
-			}
-		}
-	}
+	scene.GetResource<AF::RandomStreams>().Seed(seed);
+}
 
-	glm::vec2 m_SpeedRange;
-	float m_MaxHealth = 100.0f;
-	float m_CurrentHealth = 100.0f;
-};
+// Loads a checkpoint taken with SaveSnapshot. The resources indexed by entity aren't part of it and would still hold
+// entities from after the checkpoint, they are emptied here and rebuilt by their systems on the next tick.
+void RestoreScene(AF::ECS::Scene& scene, const std::vector<std::byte>& checkpoint)
+{
+	AF::ECS::LoadSnapshot(scene, checkpoint);
+
+	scene.GetResource<AF::SpatialGrid>().Clear();
+	scene.GetResource<AF::SweepAndPrune>().Clear();
+	scene.GetResource<AF::TrailParticles>().Clear();
+}
 
-void CreateBasicEnemy(std::shared_ptr<AF::ECS::Scene> scene)
+// Spawning happens between ticks, nothing is iterating the scene at that point
+void CreateBasicEnemy(AF::ECS::Scene& scene)
 {
-	AF::GetApplication()->InvokeLater([scene]()
-	{
-		std::shared_ptr<AF::ECS::Entity> newEntity = scene->CreateEntity();
-		newEntity->CreateComponent<EntityTag>(EntityTag::ENEMY);
-		newEntity->CreateComponent<BoxRenderer>(glm::vec4{ 1.0f, 0.0f, 0.0f, 1.0f });
-		newEntity->CreateComponent<TrailSpawner>(0.02f);
-		newEntity->CreateComponent<EdgeBouncer>();
-		newEntity->CreateComponent<Transform>();
-		newEntity->CreateComponent<RandomSpawner>();
-		newEntity->CreateComponent<RigidBody>();
-	});
+	scene.Instantiate(GetBasicEnemyPrefab());
 }
 
-void CreateFastEnemy(std::shared_ptr<AF::ECS::Scene> scene)
+void CreateFastEnemy(AF::ECS::Scene& scene)
 {
-	AF::GetApplication()->InvokeLater([scene]()
-	{
-		std::shared_ptr<AF::ECS::Entity> newEntity = scene->CreateEntity();
-		newEntity->CreateComponent<EntityTag>(EntityTag::ENEMY);
-		newEntity->CreateComponent<BoxRenderer>(glm::vec4{ 0.0f, 0.2f, 1.0f, 1.0f });
-		newEntity->CreateComponent<TrailSpawner>(0.02f);
-		newEntity->CreateComponent<EdgeBouncer>();
-		newEntity->CreateComponent<Transform>();
-		newEntity->CreateComponent<RandomSpawner>(glm::vec2{ 500.0f, 1000.0f });
-		newEntity->CreateComponent<RigidBody>();
-	});
+	scene.Instantiate(GetFastEnemyPrefab());
 }
 
-void CreatePlayer(std::shared_ptr<AF::ECS::Scene> scene)
+void CreatePlayer(AF::ECS::Scene& scene)
 {
-	AF::GetApplication()->InvokeLater([scene]()
-	{
-		std::shared_ptr<AF::ECS::Entity> newEntity = scene->CreateEntity();
-		newEntity->CreateComponent<EntityTag>(EntityTag::PLAYER);
-		newEntity->CreateComponent<BoxRenderer>(glm::vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
-		newEntity->CreateComponent<TrailSpawner>(0.02f);
-		newEntity->CreateComponent<EdgeClamper>();
-		newEntity->CreateComponent<Transform>();
-		newEntity->CreateComponent<CenterSpawner>();
-		newEntity->CreateComponent<RigidBody>();
-		newEntity->CreateComponent<PlayerControlled>();
-	});
+	scene.Instantiate(GetPlayerPrefab());
 }
 
-void CreateMenuParticle(std::shared_ptr<AF::ECS::Scene> scene)
+void CreateMenuParticle(AF::ECS::Scene& scene)
 {
-	AF::GetApplication()->InvokeLater([scene]()
-	{
-		std::shared_ptr<AF::ECS::Entity> newEntity = scene->CreateEntity();
-		newEntity->CreateComponent<EntityTag>(EntityTag::NONE);
-		newEntity->CreateComponent<BoxRenderer>(glm::vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
-		newEntity->CreateComponent<TrailSpawner>(0.02f);
-		newEntity->CreateComponent<EdgeKiller>();
-		newEntity->CreateComponent<Transform>();
-		newEntity->CreateComponent<EdgeSpawner>();
-		newEntity->CreateComponent<RigidBody>();
-		newEntity->CreateComponent<Flasher>();
-	});
+	scene.Instantiate(GetMenuParticlePrefab());
 }
 
+// Live entities and ECS memory use of a scene, refreshed every time the debugger draws
+struct DebugSceneInfo : public AF::DebuggerSection
+{
+	DebugSceneInfo(const AF::ECS::Scene* scene)
+		: m_Scene(scene)
+	{
+		m_Title = "Scene";
+	}
+
+	virtual ~DebugSceneInfo() = default;
+
+	static std::string FormatBytes(size_t used, size_t reserved)
+	{
+		return fmt::format("{:.1f} / {:.1f} KiB", used / 1024.0, reserved / 1024.0);
+	}
+
+	virtual void Update() override
+	{
+		static const std::array<const char*, 3> s_TagNames = { "None", "Player", "Enemy" };
+
+		m_Scene->GetStats(m_Stats);
+		m_Content.clear();
+
+		m_Content.push_back(std::make_pair("Entities", fmt::format("{} ({} pending destroy)", m_Stats.m_LiveEntities, m_Stats.m_PendingDestroy)));
+
+		for (size_t tag = 1; tag < m_Stats.m_Tagged.size(); ++tag)
+		{
+			std::string name = tag < s_TagNames.size() ? s_TagNames[tag] : fmt::format("Tag {}", tag);
+			m_Content.push_back(std::make_pair(std::move(name), std::to_string(m_Stats.m_Tagged[tag])));
+		}
+
+		if (const AF::TrailParticles* trails = m_Scene->FindResource<AF::TrailParticles>())
+			m_Content.push_back(std::make_pair("Trail particles", fmt::format("{} / {}", trails->Size(), trails->Capacity())));
+
+		m_Content.push_back(std::make_pair("Archetypes", std::to_string(m_Stats.m_Archetypes)));
+
+		for (const AF::ECS::ComponentStats& component : m_Stats.m_Components)
+			m_Content.push_back(std::make_pair(component.m_Info->m_Name, fmt::format("{}, {}", component.m_Count, FormatBytes(component.m_UsedBytes, component.m_ReservedBytes))));
+
+		m_Content.push_back(std::make_pair("Index", FormatBytes(m_Stats.m_IndexUsedBytes, m_Stats.m_IndexReservedBytes)));
+		m_Content.push_back(std::make_pair("Pool", FormatBytes(m_Stats.m_PoolUsedBytes, m_Stats.m_PoolReservedBytes)));
+
+		const AF::ECS::SceneChurn& churn = m_Stats.m_FrameChurn;
+		m_Content.push_back(std::make_pair("Frame churn", fmt::format("+{} -{} entities, +{} -{} blocks",
+			churn.m_EntitiesCreated, churn.m_EntitiesDestroyed, churn.m_BlockAllocations, churn.m_BlockFrees)));
+	}
+
+	const AF::ECS::Scene* m_Scene;
+	AF::ECS::SceneStats m_Stats;
+};
+
 class GameState : public AF::State
 {
 public:
@@ -550,11 +534,11 @@ public:
 
 	virtual ~GameState() = default;
 
-	virtual void Update() override
+	virtual void FixedUpdate() override
 	{
 		auto* app = AF::GetApplication();
 
-		if (m_Timer.Update(static_cast<float>(app->m_DeltaTime)))
+		if (m_Timer.Update(static_cast<float>(app->m_FixedDeltaTime)))
 		{
 			++m_CurrentLevel;
 
@@ -562,69 +546,45 @@ public:
 
 			if (m_CurrentLevel == 4)
 			{
-				/*std::vector<std::shared_ptr<Entity>> currentEntities;
-
-				for (auto entity : m_EntityManager.m_Entities)
-				{
-					if(entity->m_Tag == EntityTag::ENEMY)
-						currentEntities.push_back(entity);
-				}
-
-				for (auto entity : currentEntities)
-				{
-					m_EntityManager.RemoveEntity(entity);
-				}
-
-				for (auto entity : currentEntities)
-				{
-					auto enemy1 = std::make_shared<BasicEnemy>();
-					auto enemy2 = std::make_shared<BasicEnemy>();
-					auto enemy3 = std::make_shared<BasicEnemy>();
-					auto enemy4 = std::make_shared<BasicEnemy>();
-
-					m_EntityManager.AddEntity(enemy1);
-					m_EntityManager.AddEntity(enemy2);
-					m_EntityManager.AddEntity(enemy3);
-					m_EntityManager.AddEntity(enemy4);
-
-					enemy1->m_Size = entity->m_Size * 0.5f;
-					enemy2->m_Size = entity->m_Size * 0.5f;
-					enemy3->m_Size = entity->m_Size * 0.5f;
-					enemy4->m_Size = entity->m_Size * 0.5f;
-
-					enemy1->m_Position = entity->m_Position + glm::vec2(0.0f, 0.0f);
-					enemy2->m_Position = entity->m_Position + glm::vec2(0.0f, entity->m_Size.y * 0.25f);
-					enemy3->m_Position = entity->m_Position + glm::vec2(entity->m_Size.x * 0.25f, 0.0f);
-					enemy4->m_Position = entity->m_Position + glm::vec2(entity->m_Size.x * 0.25f, entity->m_Size.y * 0.25f);
-
-					enemy1->m_Velocity = entity->m_Velocity * 0.8f;
-					enemy2->m_Velocity = entity->m_Velocity * 0.8f;
-					enemy3->m_Velocity = entity->m_Velocity * 0.8f;
-					enemy4->m_Velocity = entity->m_Velocity * 0.8f;
-
-					float min = 32.0f;
-
-					enemy1->m_Velocity += glm::vec2{ glm::linearRand<float>(-min, min), glm::linearRand<float>(-min, min) };
-					enemy2->m_Velocity += glm::vec2{ glm::linearRand<float>(-min, min), glm::linearRand<float>(-min, min) };
-					enemy3->m_Velocity += glm::vec2{ glm::linearRand<float>(-min, min), glm::linearRand<float>(-min, min) };
-					enemy4->m_Velocity += glm::vec2{ glm::linearRand<float>(-min, min), glm::linearRand<float>(-min, min) };
-					
-				}*/
-
+				m_Scene->GetResource<EnemySplitRequest>().m_Pending = true;
 			}
 			else if(m_CurrentLevel > 5)
 			{
-				CreateFastEnemy(m_Scene);
+				CreateFastEnemy(*m_Scene);
 				
 			}
 			else
 			{
-				CreateBasicEnemy(m_Scene);
+				CreateBasicEnemy(*m_Scene);
+			}
+		}
+
+		TickScene(*m_Scene);
+	}
+
+	virtual void Update() override
+	{
+		auto* app = AF::GetApplication();
+
+		// Checkpoint and instant retry
+		if (app->m_PressedKeys.find(GLFW_KEY_F5) != app->m_PressedKeys.end())
+		{
+			if (AF::ECS::SaveSnapshot(*m_Scene, m_Checkpoint))
+			{
+				m_CheckpointTimer = m_Timer;
+				m_CheckpointLevel = m_CurrentLevel;
 			}
 		}
 
+		if (app->m_PressedKeys.find(GLFW_KEY_F9) != app->m_PressedKeys.end() && !m_Checkpoint.empty())
+		{
+			RestoreScene(*m_Scene, m_Checkpoint);
+			m_Timer = m_CheckpointTimer;
+			m_CurrentLevel = m_CheckpointLevel;
+		}
+
 		app->m_Renderer.BeginFrame(app->m_ReferenceSize);
-		m_Scene->Update();
+		RenderScene(*m_Scene);
 		app->m_Renderer.EndFrame();
 
 		app->m_Renderer.BeginFrame(app->m_Size);
@@ -634,17 +594,40 @@ public:
 
 	virtual void Attach() override
 	{
-		CreatePlayer(m_Scene);
+		SeedScene(*m_Scene);
+		CreatePlayer(*m_Scene);
+
+		AF::Debugger::s_Sections.push_back(&m_SceneDebugger);
 	}
 
 	virtual void Detach() override
 	{
+		auto& sections = AF::Debugger::s_Sections;
+		sections.erase(std::remove(sections.begin(), sections.end(), &m_SceneDebugger), sections.end());
 	}
 
+	DebugSceneInfo m_SceneDebugger = DebugSceneInfo(m_Scene.get());
+
 	AF::Timer<float> m_Timer = AF::Timer<float>(5.0f);
 	int m_CurrentLevel = 0;
+
+	std::vector<std::byte> m_Checkpoint;
+	AF::Timer<float> m_CheckpointTimer = m_Timer;
+	int m_CheckpointLevel = 0;
 };
 
+void MenuState::FixedUpdate()
+{
+	auto* app = AF::GetApplication();
+
+	if (m_Timer.Update(static_cast<float>(app->m_FixedDeltaTime)))
+	{
+		CreateMenuParticle(*m_Scene);
+	}
+
+	TickScene(*m_Scene);
+}
+
 void MenuState::Update()
 {
 	auto* app = AF::GetApplication();
@@ -678,7 +661,7 @@ void MenuState::Update()
 	};
 
 	app->m_Renderer.BeginFrame(app->m_ReferenceSize);
-	m_Scene->Update();
+	RenderScene(*m_Scene);
 	app->m_Renderer.EndFrame();
 
 	app->m_Renderer.BeginFrame(app->m_Size);
@@ -688,7 +671,7 @@ void MenuState::Update()
 	float spacing = app->m_Size.y / (static_cast<float>(texts.size()) * 2.0f);
 	float mainX = app->m_Size.x / 2.0f;
 
-	nvgTextAlign(app->m_Renderer.m_Vg, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
+	app->m_Renderer.TextAlign(NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
 
 	if (app->m_PressedKeys.find(GLFW_KEY_W) != app->m_PressedKeys.end()) --selectedOption;
 	if (app->m_PressedKeys.find(GLFW_KEY_S) != app->m_PressedKeys.end()) ++selectedOption;
@@ -715,32 +698,43 @@ void MenuState::Update()
 			app->m_Renderer.FontSize(app->ComputeFromReference(120.0f));
 
 			app->m_Renderer.FillColor({ 1.0f, 1.0f, b, 0.5f });
-			nvgText(app->m_Renderer.m_Vg, x, y, texts[i].name, nullptr);
+			app->m_Renderer.Text({ x, y }, texts[i].name);
+
+			AF::Random& random = m_Scene->GetResource<AF::RandomStreams>().Get(RandomStream::EFFECTS);
 
 			float offsetSize = app->ComputeFromReference(5);
-			x += glm::linearRand<float>(-offsetSize, offsetSize);
-			y += glm::linearRand<float>(-offsetSize, offsetSize);
+			x += random.Float(-offsetSize, offsetSize);
+			y += random.Float(-offsetSize, offsetSize);
 		}
 		else
 			app->m_Renderer.FontSize(app->ComputeFromReference(60.0f));
 
 		app->m_Renderer.FillColor({ 1.0f, 1.0f, b, 1.0f });
-		nvgText(app->m_Renderer.m_Vg, x, y, texts[i].name, nullptr);
+		app->m_Renderer.Text({ x, y }, texts[i].name);
 	}
 		
 	AF::Debugger::Update();
 
 
 	app->m_Renderer.EndFrame();
+}
 
-	if (m_Timer.Update(static_cast<float>(app->m_DeltaTime)))
-	{
-		CreateMenuParticle(m_Scene);
-	}
+static void GameOver(const std::weak_ptr<AF::State>& lost)
+{
+	if (lost.lock() != AF::GetApplication()->m_StateManager.GetState()) return;
+
+#ifdef AF_HEADLESS
+	// Nobody is there to pick from the menu, the next round starts right away
+	AF_INFO("Game over at tick {}", AF::GetApplication()->m_Tick);
+	AF::GetApplication()->m_StateManager.SetState(std::make_shared<GameState>());
+#else
+	AF::GetApplication()->m_StateManager.SetState(std::make_shared<MenuState>());
+#endif
 }
 
 void MenuState::Attach()
-{	
+{
+	SeedScene(*m_Scene);
 }
 
 void MenuState::Detach()
@@ -755,7 +749,11 @@ namespace AF
 
 		app->InvokeLater([app]()
 		{
+#ifdef AF_HEADLESS
+			app->m_StateManager.SetState(std::make_shared<GameState>());
+#else
 			app->m_StateManager.SetState(std::make_shared<MenuState>());
+#endif
 		});
 
 		return app;
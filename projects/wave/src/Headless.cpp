@@ -0,0 +1,301 @@
+#include "Application.h"
+
+// Runs the game without a window, GL context or audio for soak testing and profiling.
+// Time is virtual, the simulation runs as fast as it can unless --realtime is given.
+//
+// Options:
+//   --minutes <n>          Simulated minutes to run for, 5 by default
+//   --tick-rate <hz>       Simulation ticks per second
+//   --frame-rate <hz>      Virtual frames per second, one tick per frame by default
+//   --script <file>        Input script, lines of `<seconds> <key> <down|up|press>`, '#' starts a comment
+//   --report-every <s>     Log a progress report every this many simulated seconds
+//   --realtime             Sleep so simulated time keeps pace with the wall clock
+//   --seed <n>             Seed for every random stream, taken from the clock by default
+#ifdef AF_HEADLESS
+
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
+#include <ctime>
+
+#include "Log.h"
+#include "Debugger.h"
+
+#if defined(AF_PLAT_LINUX)
+	#include <sys/resource.h>
+#elif defined(AF_PLAT_WINDOWS)
+	#define NOMINMAX
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+	#include <Psapi.h>
+#endif
+
+namespace AF
+{
+	enum class InputAction
+	{
+		Down,
+		Up,
+		Press
+	};
+
+	struct InputEvent
+	{
+		double m_Time;
+		int m_Key;
+		InputAction m_Action;
+	};
+
+	struct HeadlessOptions
+	{
+		double m_Minutes = 5.0;
+		double m_FrameTime = 0.0;
+		double m_ReportEvery = 0.0;
+		bool m_Realtime = false;
+
+		// Sorted by time
+		std::vector<InputEvent> m_Script;
+	};
+
+	static HeadlessOptions s_Options;
+
+	static int ParseKey(std::string name)
+	{
+		std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+		// Letters and digits share their ascii value with the glfw key code
+		if (name.size() == 1 && std::isalnum(static_cast<unsigned char>(name[0]))) return name[0];
+
+		if (name.size() > 1 && name[0] == 'F')
+		{
+			int number = std::atoi(name.c_str() + 1);
+			if (number >= 1 && number <= 25) return GLFW_KEY_F1 + number - 1;
+		}
+
+		if (name == "SPACE") return GLFW_KEY_SPACE;
+		if (name == "ENTER") return GLFW_KEY_ENTER;
+		if (name == "ESCAPE") return GLFW_KEY_ESCAPE;
+		if (name == "UP") return GLFW_KEY_UP;
+		if (name == "DOWN") return GLFW_KEY_DOWN;
+		if (name == "LEFT") return GLFW_KEY_LEFT;
+		if (name == "RIGHT") return GLFW_KEY_RIGHT;
+
+		return GLFW_KEY_UNKNOWN;
+	}
+
+	static bool LoadScript(const std::string& path, std::vector<InputEvent>& script)
+	{
+		std::ifstream file(path);
+		if (!file) return false;
+
+		std::string line;
+		int number = 0;
+
+		while (std::getline(file, line))
+		{
+			++number;
+
+			line = line.substr(0, line.find('#'));
+
+			std::istringstream stream(line);
+			InputEvent event;
+			std::string key, action;
+
+			if (!(stream >> event.m_Time)) continue;
+
+			if (!(stream >> key >> action))
+			{
+				AF_WARN("{}:{}: expected `<seconds> <key> <down|up|press>`", path, number);
+				continue;
+			}
+
+			event.m_Key = ParseKey(key);
+
+			if (event.m_Key == GLFW_KEY_UNKNOWN)
+			{
+				AF_WARN("{}:{}: unknown key `{}`", path, number, key);
+				continue;
+			}
+
+			if (action == "down") event.m_Action = InputAction::Down;
+			else if (action == "up") event.m_Action = InputAction::Up;
+			else if (action == "press") event.m_Action = InputAction::Press;
+			else
+			{
+				AF_WARN("{}:{}: unknown action `{}`", path, number, action);
+				continue;
+			}
+
+			script.push_back(event);
+		}
+
+		std::stable_sort(script.begin(), script.end(), [](const InputEvent& a, const InputEvent& b) { return a.m_Time < b.m_Time; });
+		return true;
+	}
+
+	// Holds W, D, S and A in turn so the player keeps circling
+	static void DefaultScript(double duration, std::vector<InputEvent>& script)
+	{
+		static const int s_Keys[] = { GLFW_KEY_W, GLFW_KEY_D, GLFW_KEY_S, GLFW_KEY_A };
+		constexpr double step = 0.5;
+
+		for (int i = 0; i * step < duration; ++i)
+		{
+			if (i > 0) script.push_back({ i * step, s_Keys[(i - 1) % 4], InputAction::Up });
+			script.push_back({ i * step, s_Keys[i % 4], InputAction::Down });
+		}
+	}
+
+	// In KiB, 0 when the platform doesn't tell
+	static size_t PeakMemory()
+	{
+#if defined(AF_PLAT_LINUX)
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0) return static_cast<size_t>(usage.ru_maxrss);
+#elif defined(AF_PLAT_WINDOWS)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return counters.PeakWorkingSetSize / 1024;
+#endif
+		return 0;
+	}
+
+	void Application::Start()
+	{
+		if (m_Running) return;
+		m_Running = true;
+
+		AF_INFO("Starting headless application");
+
+		EarlyInit();
+		Init();
+
+		const uint64_t totalTicks = static_cast<uint64_t>(s_Options.m_Minutes * 60.0 / m_FixedDeltaTime);
+		const uint64_t reportTicks = static_cast<uint64_t>(s_Options.m_ReportEvery / m_FixedDeltaTime);
+
+		size_t nextEvent = 0;
+		uint64_t lastReport = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		auto lastReportTime = start;
+
+		AF_INFO("Running {:.1f} simulated minutes, {} ticks at {:.0f} Hz", s_Options.m_Minutes, totalTicks, 1.0 / m_FixedDeltaTime);
+
+		while (m_Running && m_Tick < totalTicks)
+		{
+			double time = static_cast<double>(m_Tick) * m_FixedDeltaTime;
+
+			for (; nextEvent < s_Options.m_Script.size() && s_Options.m_Script[nextEvent].m_Time <= time; ++nextEvent)
+			{
+				const InputEvent& event = s_Options.m_Script[nextEvent];
+
+				switch (event.m_Action)
+				{
+					case InputAction::Down:
+						m_Keys.insert(event.m_Key);
+						m_PressedKeys.insert(event.m_Key);
+						break;
+					case InputAction::Up:
+						m_Keys.erase(event.m_Key);
+						break;
+					case InputAction::Press:
+						m_PressedKeys.insert(event.m_Key);
+						break;
+				}
+			}
+
+			m_DeltaTime = s_Options.m_FrameTime;
+			Update();
+
+			if (s_Options.m_Realtime)
+				std::this_thread::sleep_until(start + std::chrono::duration<double>(static_cast<double>(m_Tick) * m_FixedDeltaTime));
+
+			if (reportTicks != 0 && m_Tick - lastReport >= reportTicks)
+			{
+				auto now = std::chrono::steady_clock::now();
+				double elapsed = std::chrono::duration<double>(now - lastReportTime).count();
+
+				AF_INFO("{:.0f}s simulated, {:.0f} ticks/s, peak memory {} KiB\n{}", time, (m_Tick - lastReport) / elapsed, PeakMemory(), Debugger::Format());
+
+				lastReport = m_Tick;
+				lastReportTime = now;
+			}
+		}
+
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double simulated = static_cast<double>(m_Tick) * m_FixedDeltaTime;
+		size_t peakMemory = PeakMemory();
+
+		AF_INFO("Ran {} ticks in {:.2f}s", m_Tick, elapsed);
+		AF_INFO("{:.0f} ticks/s, {:.1f}x realtime", m_Tick / elapsed, simulated / elapsed);
+
+		if (peakMemory != 0) AF_INFO("Peak memory {:.1f} MiB", peakMemory / 1024.0);
+		else AF_INFO("Peak memory unavailable on this platform");
+
+		AF_INFO("Final state\n{}", Debugger::Format());
+
+		Destroy();
+
+		AF_INFO("Stopped headless application");
+	}
+
+	void Application::EarlyInit()
+	{
+		AF_DEBUG("Starting EarlyInit");
+
+		std::string script;
+		m_Seed = static_cast<uint64_t>(std::time(nullptr));
+
+		for (size_t i = 0; i < m_Arguments.size(); ++i)
+		{
+			const std::string& argument = m_Arguments[i];
+			bool hasValue = i + 1 < m_Arguments.size();
+
+			if (argument == "--realtime") s_Options.m_Realtime = true;
+			else if (!hasValue) AF_WARN("Ignoring argument `{}`", argument);
+			else if (argument == "--minutes") s_Options.m_Minutes = std::atof(m_Arguments[++i].c_str());
+			else if (argument == "--tick-rate") m_FixedDeltaTime = 1.0 / std::atof(m_Arguments[++i].c_str());
+			else if (argument == "--frame-rate") s_Options.m_FrameTime = 1.0 / std::atof(m_Arguments[++i].c_str());
+			else if (argument == "--report-every") s_Options.m_ReportEvery = std::atof(m_Arguments[++i].c_str());
+			else if (argument == "--script") script = m_Arguments[++i];
+			else if (argument == "--seed") m_Seed = std::strtoull(m_Arguments[++i].c_str(), nullptr, 10);
+			else AF_WARN("Ignoring argument `{}`", argument);
+		}
+
+		AF_ASSERT(m_FixedDeltaTime > 0.0, "Tick rate must be positive");
+
+		m_Random.Seed(m_Seed);
+		AF_INFO("Seed {}, pass --seed {} to replay this run", m_Seed, m_Seed);
+
+		// Without a frame rate every frame runs exactly one tick
+		if (s_Options.m_FrameTime <= 0.0) s_Options.m_FrameTime = m_FixedDeltaTime;
+
+		if (script.empty())
+		{
+			DefaultScript(s_Options.m_Minutes * 60.0, s_Options.m_Script);
+		}
+		else
+		{
+			bool loaded = LoadScript(script, s_Options.m_Script);
+			AF_ASSERT(loaded, "Failed to open input script {}", script);
+		}
+	}
+
+	void Application::Init()
+	{
+		AF_DEBUG("Starting Init");
+
+		// Nothing is drawn, the debugger text is only built for the reports
+		Debugger::s_Enabled = false;
+	}
+
+	void Application::Destroy()
+	{
+		AF_DEBUG("Destroying headless application");
+	}
+}
+
+#endif
\ No newline at end of file
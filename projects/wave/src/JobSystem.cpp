@@ -0,0 +1,202 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace AF
+{
+	// Which pool and queue the current thread works for, used to push nested jobs onto the worker's own deque
+	static thread_local const JobSystem* s_WorkerOwner = nullptr;
+	static thread_local size_t s_WorkerQueue = 0;
+
+	void JobSystem::WorkQueue::PushBack(QueuedJob&& job)
+	{
+		if (m_Count == m_Jobs.size())
+		{
+			// Unwraps the jobs into the front of a larger buffer
+			std::vector<QueuedJob> jobs(std::max<size_t>(m_Jobs.size() * 2, 64));
+
+			for (size_t i = 0; i < m_Count; ++i)
+				jobs[i] = std::move(m_Jobs[(m_Head + i) % m_Jobs.size()]);
+
+			m_Jobs = std::move(jobs);
+			m_Head = 0;
+		}
+
+		m_Jobs[(m_Head + m_Count) % m_Jobs.size()] = std::move(job);
+		++m_Count;
+	}
+
+	void JobSystem::WorkQueue::PopBack(QueuedJob& job)
+	{
+		--m_Count;
+		job = std::move(m_Jobs[(m_Head + m_Count) % m_Jobs.size()]);
+	}
+
+	void JobSystem::WorkQueue::PopFront(QueuedJob& job)
+	{
+		job = std::move(m_Jobs[m_Head]);
+		m_Head = (m_Head + 1) % m_Jobs.size();
+		--m_Count;
+	}
+
+	JobSystem::JobSystem(size_t workerCount)
+	{
+		if (workerCount == 0)
+		{
+			unsigned int hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		// The last queue is shared by threads outside the pool
+		for (size_t i = 0; i < workerCount + 1; ++i)
+			m_Queues.push_back(std::make_unique<WorkQueue>());
+
+		for (size_t i = 0; i < workerCount; ++i)
+			m_Workers.emplace_back([this, i]() { WorkerMain(i); });
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_Stopping = true;
+		}
+
+		m_Condition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	size_t JobSystem::CurrentQueue() const
+	{
+		return s_WorkerOwner == this ? s_WorkerQueue : m_Queues.size() - 1;
+	}
+
+	void JobSystem::Submit(Job job, JobCounter& counter)
+	{
+		AF_COUNT_SYNC_OP();
+		++counter.m_Pending;
+
+		WorkQueue& queue = *m_Queues[CurrentQueue()];
+
+		{
+			std::lock_guard<std::mutex> lock(queue.m_Mutex);
+			queue.PushBack({ std::move(job), &counter });
+		}
+
+		++m_QueuedCount;
+
+		// Taking the lock orders this against a worker that is about to sleep, so the wakeup can't be lost
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+		}
+
+		m_Condition.notify_one();
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		AF_COUNT_SYNC_OP();
+		size_t queue = CurrentQueue();
+
+		while (counter.m_Pending.load() != 0)
+		{
+			if (!TryRunOne(queue))
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& function)
+	{
+		if (count == 0) return;
+		if (chunkSize == 0) chunkSize = 1;
+
+		size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+		if (chunkCount == 1)
+		{
+			function(0, count);
+			return;
+		}
+
+		struct Range
+		{
+			const std::function<void(size_t, size_t)>* m_Function;
+			size_t m_Count;
+			size_t m_ChunkSize;
+		}
+		range = { &function, count, chunkSize };
+
+		JobCounter counter;
+
+		// The first chunk runs here, the rest are captured as two words each so the jobs stay allocation free
+		for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+		{
+			Submit([range = &range, chunk]()
+			{
+				size_t begin = chunk * range->m_ChunkSize;
+				size_t end = std::min(begin + range->m_ChunkSize, range->m_Count);
+				(*range->m_Function)(begin, end);
+			}, counter);
+		}
+
+		function(0, chunkSize);
+		Wait(counter);
+	}
+
+	bool JobSystem::Pop(size_t queue, QueuedJob& job)
+	{
+		WorkQueue& workQueue = *m_Queues[queue];
+		std::lock_guard<std::mutex> lock(workQueue.m_Mutex);
+
+		if (workQueue.m_Count == 0) return false;
+
+		workQueue.PopBack(job);
+		return true;
+	}
+
+	bool JobSystem::Steal(size_t thief, QueuedJob& job)
+	{
+		for (size_t offset = 1; offset < m_Queues.size(); ++offset)
+		{
+			WorkQueue& workQueue = *m_Queues[(thief + offset) % m_Queues.size()];
+			std::lock_guard<std::mutex> lock(workQueue.m_Mutex);
+
+			if (workQueue.m_Count == 0) continue;
+
+			workQueue.PopFront(job);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool JobSystem::TryRunOne(size_t queue)
+	{
+		QueuedJob job;
+		if (!Pop(queue, job) && !Steal(queue, job)) return false;
+
+		--m_QueuedCount;
+
+		job.m_Job();
+		--job.m_Counter->m_Pending;
+		return true;
+	}
+
+	void JobSystem::WorkerMain(size_t index)
+	{
+		s_WorkerOwner = this;
+		s_WorkerQueue = index;
+
+		while (true)
+		{
+			if (TryRunOne(index)) continue;
+
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+			m_Condition.wait(lock, [this]() { return m_Stopping || m_QueuedCount.load() != 0; });
+
+			if (m_Stopping && m_QueuedCount.load() == 0) return;
+		}
+	}
+}
\ No newline at end of file
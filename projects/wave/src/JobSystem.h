@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+#if defined(AF_COUNT_SYNC)
+#	define AF_COUNT_SYNC_OP() ++::AF::s_SyncOperations
+#else
+#	define AF_COUNT_SYNC_OP()
+#endif
+
+namespace AF
+{
+#if defined(AF_COUNT_SYNC)
+	// Job submissions and waits made by the job system at the points marked with AF_COUNT_SYNC_OP.
+	// Only those points are counted, anything else that synchronises is invisible to it.
+	inline std::atomic<uint64_t> s_SyncOperations = 0;
+#endif
+
+	// Tracks a group of submitted jobs, Wait returns once all of them have finished
+	struct JobCounter
+	{
+		std::atomic<size_t> m_Pending = 0;
+	};
+
+	// Every worker owns a deque, it pushes and pops at the back while idle workers steal from the front of
+	// the others. Jobs submitted from outside the pool go to an extra shared deque that everyone steals from.
+	class JobSystem final
+	{
+	public:
+		using Job = std::function<void()>;
+
+		// A worker count of zero uses one worker per hardware thread except the calling one
+		JobSystem(size_t workerCount = 0);
+		JobSystem(const JobSystem&) = delete;
+		~JobSystem();
+
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		void Submit(Job job, JobCounter& counter);
+
+		// Runs queued jobs on the calling thread until the counter reaches zero
+		void Wait(JobCounter& counter);
+
+		// Splits [0, count) into chunks of `chunkSize` and calls `function(begin, end)` once per chunk across the pool.
+		// Chunk boundaries only depend on the arguments, results are deterministic as long as chunks don't share writes.
+		void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& function);
+
+		size_t WorkerCount() const
+		{
+			return m_Workers.size();
+		}
+	private:
+		struct QueuedJob
+		{
+			Job m_Job;
+			JobCounter* m_Counter;
+		};
+
+		// Ring buffer used as a deque, it keeps its storage once grown so steady state submits don't allocate
+		struct WorkQueue
+		{
+			std::mutex m_Mutex;
+			std::vector<QueuedJob> m_Jobs;
+			size_t m_Head = 0;
+			size_t m_Count = 0;
+
+			void PushBack(QueuedJob&& job);
+			void PopBack(QueuedJob& job);
+			void PopFront(QueuedJob& job);
+		};
+
+		size_t CurrentQueue() const;
+		bool Pop(size_t queue, QueuedJob& job);
+		bool Steal(size_t thief, QueuedJob& job);
+		bool TryRunOne(size_t queue);
+		void WorkerMain(size_t index);
+
+		std::vector<std::thread> m_Workers;
+		std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+		std::atomic<size_t> m_QueuedCount = 0;
+
+		std::mutex m_SleepMutex;
+		std::condition_variable m_Condition;
+		std::atomic<bool> m_Stopping = false;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Log.h"
 
+#include <spdlog/sinks/stdout_color_sinks.h>
+
 namespace AF
 {
 	std::shared_ptr<spdlog::logger> s_Logger;
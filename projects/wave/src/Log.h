@@ -16,7 +16,7 @@
 #define AF_WARN(...) ::AF::s_Logger->warn(__VA_ARGS__)
 #define AF_ERROR(...) ::AF::s_Logger->error(__VA_ARGS__)
 #define AF_CRITICAL(...) ::AF::s_Logger->critical(__VA_ARGS__)
-#define AF_ASSERT(statement, ...) if(!(statement)) { AF_CRITICAL(__VA_ARGS__); __debugbreak(); }
+#define AF_ASSERT(statement, ...) if(!(statement)) { AF_CRITICAL(__VA_ARGS__); AF_DEBUGBREAK(); }
 
 #if defined(AF_CONF_DEBUG)
 #	define AF_CONF_STR "DEB"
@@ -30,6 +30,10 @@
 
 #if defined(AF_PLAT_WINDOWS)
 #	define AF_PLAT_STR "WIN"
+#	define AF_DEBUGBREAK() __debugbreak()
+#elif defined(AF_PLAT_LINUX)
+#	define AF_PLAT_STR "LINUX"
+#	define AF_DEBUGBREAK() __builtin_trap()
 #else
 #	error "Invalid platform"
 #endif
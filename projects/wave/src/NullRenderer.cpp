@@ -0,0 +1,61 @@
+#include "Renderer.h"
+
+// Headless builds have no GL context to draw into, everything that would be drawn is dropped here
+#ifdef AF_HEADLESS
+
+namespace AF
+{
+	void Renderer::BeginFrame(glm::vec2)
+	{
+	}
+
+	void Renderer::EndFrame()
+	{
+	}
+
+	void Renderer::BeginPath()
+	{
+	}
+
+	void Renderer::Fill()
+	{
+	}
+
+	void Renderer::FillColor(glm::vec4)
+	{
+	}
+
+	void Renderer::Rect(glm::vec2, glm::vec2)
+	{
+	}
+
+	void Renderer::FontFace(const char*)
+	{
+	}
+
+	void Renderer::FontSize(float)
+	{
+	}
+
+	void Renderer::TextAlign(int)
+	{
+	}
+
+	void Renderer::Text(glm::vec2, const char*)
+	{
+	}
+
+	void Renderer::TextBox(glm::vec2, float, const char*)
+	{
+	}
+
+	void Renderer::VGRP_FillRect(glm::vec2, glm::vec2, glm::vec4)
+	{
+	}
+
+	void Renderer::FillRects(const glm::vec2*, const glm::vec2*, const glm::vec4*, size_t)
+	{
+	}
+}
+
+#endif
\ No newline at end of file
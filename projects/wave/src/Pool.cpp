@@ -0,0 +1,106 @@
+#include "Pool.h"
+
+#include <new>
+
+namespace AF
+{
+	BlockPool::~BlockPool()
+	{
+		Reset();
+	}
+
+	size_t BlockPool::SizeClass(size_t size)
+	{
+		size_t sizeClass = 0;
+		size_t blockSize = s_MinBlockSize;
+
+		while (blockSize < size)
+		{
+			blockSize <<= 1;
+			++sizeClass;
+		}
+
+		return sizeClass;
+	}
+
+	void* BlockPool::Allocate(size_t size)
+	{
+		size_t sizeClass = SizeClass(size);
+		size_t bytes = s_MinBlockSize << sizeClass;
+
+		++m_Allocations;
+		m_UsedBytes += bytes;
+
+		if (FreeBlock* block = m_FreeLists[sizeClass])
+		{
+			m_FreeLists[sizeClass] = block->m_Next;
+			return block;
+		}
+
+		// Oversized blocks get a slab of their own
+		if (bytes > s_SlabSize)
+		{
+			std::byte* slab = static_cast<std::byte*>(::operator new(bytes));
+			m_Slabs.push_back(slab);
+			m_ReservedBytes += bytes;
+			return slab;
+		}
+
+		if (m_Remaining < bytes)
+		{
+			// Whatever is left of the current slab is split into free blocks rather than wasted
+			while (m_Remaining >= s_MinBlockSize)
+			{
+				size_t leftoverClass = SizeClass(m_Remaining);
+				if ((s_MinBlockSize << leftoverClass) > m_Remaining) --leftoverClass;
+
+				size_t leftover = s_MinBlockSize << leftoverClass;
+				PushFree(m_Cursor, leftoverClass);
+				m_Cursor += leftover;
+				m_Remaining -= leftover;
+			}
+
+			m_Cursor = static_cast<std::byte*>(::operator new(s_SlabSize));
+			m_Remaining = s_SlabSize;
+			m_Slabs.push_back(m_Cursor);
+			m_ReservedBytes += s_SlabSize;
+		}
+
+		void* block = m_Cursor;
+		m_Cursor += bytes;
+		m_Remaining -= bytes;
+		return block;
+	}
+
+	void BlockPool::Free(void* block, size_t size)
+	{
+		if (!block) return;
+
+		size_t sizeClass = SizeClass(size);
+
+		++m_Frees;
+		m_UsedBytes -= s_MinBlockSize << sizeClass;
+
+		PushFree(block, sizeClass);
+	}
+
+	void BlockPool::PushFree(void* block, size_t sizeClass)
+	{
+		FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+		freeBlock->m_Next = m_FreeLists[sizeClass];
+		m_FreeLists[sizeClass] = freeBlock;
+	}
+
+	void BlockPool::Reset()
+	{
+		for (std::byte* slab : m_Slabs)
+			::operator delete(slab);
+
+		m_Slabs.clear();
+		m_Cursor = nullptr;
+		m_Remaining = 0;
+		m_FreeLists.fill(nullptr);
+		m_ReservedBytes = 0;
+		m_UsedBytes = 0;
+	}
+}
\ No newline at end of file
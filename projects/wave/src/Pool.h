@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace AF
+{
+	// Hands out power of two sized blocks carved from large slabs. Freed blocks go onto a free list
+	// for their size class and are reused, so steady state allocation never reaches the system allocator.
+	// All slabs are released together when the pool is reset or destroyed.
+	class BlockPool final
+	{
+	public:
+		BlockPool() = default;
+		BlockPool(const BlockPool&) = delete;
+		~BlockPool();
+
+		BlockPool& operator=(const BlockPool&) = delete;
+
+		// Returns a block of at least `size` bytes, `Free` must be given the same size
+		void* Allocate(size_t size);
+		void Free(void* block, size_t size);
+
+		void Reset();
+
+		// Bytes taken from the system allocator, and the part of it currently handed out as blocks
+		size_t ReservedBytes() const
+		{
+			return m_ReservedBytes;
+		}
+
+		size_t UsedBytes() const
+		{
+			return m_UsedBytes;
+		}
+
+		// Running totals of Allocate and Free calls, compare two readings for the churn in between
+		uint64_t Allocations() const
+		{
+			return m_Allocations;
+		}
+
+		uint64_t Frees() const
+		{
+			return m_Frees;
+		}
+
+		static constexpr size_t s_MinBlockSize = 64;
+		static constexpr size_t s_SlabSize = 256 * 1024;
+	private:
+		static size_t SizeClass(size_t size);
+		void PushFree(void* block, size_t sizeClass);
+
+		struct FreeBlock
+		{
+			FreeBlock* m_Next;
+		};
+
+		std::vector<std::byte*> m_Slabs;
+		std::byte* m_Cursor = nullptr;
+		size_t m_Remaining = 0;
+		std::array<FreeBlock*, 48> m_FreeLists = {};
+
+		size_t m_ReservedBytes = 0;
+		size_t m_UsedBytes = 0;
+		uint64_t m_Allocations = 0;
+		uint64_t m_Frees = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "Prefabs.h"
+
+#include "Components.h"
+
+static AF::ECS::Prefab CreateEnemyPrefab(glm::vec4 color)
+{
+	AF::ECS::Prefab prefab;
+	prefab.SetTag(EntityTag::ENEMY);
+	prefab.Add<BoxRenderer>(color);
+	prefab.Add<TrailSpawner>(0.02f);
+	prefab.Add<EdgeBouncer>();
+	prefab.Add<Transform>();
+	prefab.Add<RigidBody>();
+	return prefab;
+}
+
+const AF::ECS::Prefab& GetBasicEnemyPrefab()
+{
+	static const AF::ECS::Prefab s_Prefab = std::move(CreateEnemyPrefab({ 1.0f, 0.0f, 0.0f, 1.0f }).Add<RandomSpawner>());
+	return s_Prefab;
+}
+
+const AF::ECS::Prefab& GetFastEnemyPrefab()
+{
+	static const AF::ECS::Prefab s_Prefab = std::move(CreateEnemyPrefab({ 0.0f, 0.2f, 1.0f, 1.0f }).Add<RandomSpawner>(glm::vec2{ 500.0f, 1000.0f }));
+	return s_Prefab;
+}
+
+// Split pieces are placed by SplitEnemies so they have no spawner
+const AF::ECS::Prefab& GetSplitEnemyPrefab()
+{
+	static const AF::ECS::Prefab s_Prefab = CreateEnemyPrefab({ 1.0f, 0.0f, 0.0f, 1.0f });
+	return s_Prefab;
+}
+
+const AF::ECS::Prefab& GetPlayerPrefab()
+{
+	static const AF::ECS::Prefab s_Prefab = []()
+	{
+		AF::ECS::Prefab prefab;
+		prefab.SetTag(EntityTag::PLAYER);
+		prefab.Add<BoxRenderer>(glm::vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+		prefab.Add<TrailSpawner>(0.02f);
+		prefab.Add<EdgeClamper>();
+		prefab.Add<Transform>();
+		prefab.Add<CenterSpawner>();
+		prefab.Add<RigidBody>();
+		prefab.Add<PlayerControlled>();
+		return prefab;
+	}();
+
+	return s_Prefab;
+}
+
+const AF::ECS::Prefab& GetMenuParticlePrefab()
+{
+	static const AF::ECS::Prefab s_Prefab = []()
+	{
+		AF::ECS::Prefab prefab;
+		prefab.Add<BoxRenderer>(glm::vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+		prefab.Add<TrailSpawner>(0.02f);
+		prefab.Add<EdgeKiller>();
+		prefab.Add<Transform>();
+		prefab.Add<EdgeSpawner>();
+		prefab.Add<RigidBody>();
+		prefab.Add<Flasher>();
+		return prefab;
+	}();
+
+	return s_Prefab;
+}
\ No newline at end of file
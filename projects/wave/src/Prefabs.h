@@ -0,0 +1,10 @@
+#pragma once
+
+#include "ECS.h"
+
+// Component mixes for everything the game spawns, shared with the ECS benchmark
+const AF::ECS::Prefab& GetBasicEnemyPrefab();
+const AF::ECS::Prefab& GetFastEnemyPrefab();
+const AF::ECS::Prefab& GetSplitEnemyPrefab();
+const AF::ECS::Prefab& GetPlayerPrefab();
+const AF::ECS::Prefab& GetMenuParticlePrefab();
\ No newline at end of file
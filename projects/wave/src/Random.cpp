@@ -0,0 +1,166 @@
+#include "Random.h"
+
+#include "Log.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+	#define AF_SIMD_X86
+
+	#include <emmintrin.h>
+#endif
+
+namespace AF
+{
+	static uint64_t SplitMix64(uint64_t& state)
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	static uint32_t RotateLeft(uint32_t value, int count)
+	{
+		return (value << count) | (value >> (32 - count));
+	}
+
+	// Top 24 bits to [0, 1), the most a float holds exactly
+	static float ToUnitFloat(uint32_t value)
+	{
+		return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
+	}
+
+	Random::Random(uint64_t seed, uint64_t stream)
+	{
+		Seed(seed, stream);
+	}
+
+	void Random::Seed(uint64_t seed, uint64_t stream)
+	{
+		uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ull);
+
+		for (size_t i = 0; i < m_State.size(); i += 2)
+		{
+			uint64_t value = SplitMix64(state);
+			m_State[i] = static_cast<uint32_t>(value);
+			m_State[i + 1] = static_cast<uint32_t>(value >> 32);
+		}
+
+		for (std::array<uint32_t, 4>& word : m_Lanes)
+		{
+			for (size_t lane = 0; lane < word.size(); lane += 2)
+			{
+				uint64_t value = SplitMix64(state);
+				word[lane] = static_cast<uint32_t>(value);
+				word[lane + 1] = static_cast<uint32_t>(value >> 32);
+			}
+		}
+	}
+
+	uint32_t Random::Next()
+	{
+		uint32_t result = m_State[0] + m_State[3];
+		uint32_t t = m_State[1] << 9;
+
+		m_State[2] ^= m_State[0];
+		m_State[3] ^= m_State[1];
+		m_State[1] ^= m_State[2];
+		m_State[0] ^= m_State[3];
+		m_State[2] ^= t;
+		m_State[3] = RotateLeft(m_State[3], 11);
+
+		return result;
+	}
+
+	float Random::Float(float min, float max)
+	{
+		return min + ToUnitFloat(Next()) * (max - min);
+	}
+
+	int Random::Int(int min, int max)
+	{
+		// Scales by the high bits, the low ones of xoshiro128+ are its weakest
+		uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+		return static_cast<int>(min + static_cast<int64_t>((Next() * range) >> 32));
+	}
+
+	void Random::Fill(float* out, size_t count, float min, float max)
+	{
+		float scale = (max - min) * (1.0f / 16777216.0f);
+		size_t i = 0;
+
+#ifdef AF_SIMD_X86
+		__m128i s0 = _mm_load_si128(reinterpret_cast<const __m128i*>(m_Lanes[0].data()));
+		__m128i s1 = _mm_load_si128(reinterpret_cast<const __m128i*>(m_Lanes[1].data()));
+		__m128i s2 = _mm_load_si128(reinterpret_cast<const __m128i*>(m_Lanes[2].data()));
+		__m128i s3 = _mm_load_si128(reinterpret_cast<const __m128i*>(m_Lanes[3].data()));
+
+		__m128 offset = _mm_set1_ps(min);
+		__m128 factor = _mm_set1_ps(scale);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i result = _mm_add_epi32(s0, s3);
+			__m128i t = _mm_slli_epi32(s1, 9);
+
+			s2 = _mm_xor_si128(s2, s0);
+			s3 = _mm_xor_si128(s3, s1);
+			s1 = _mm_xor_si128(s1, s2);
+			s0 = _mm_xor_si128(s0, s3);
+			s2 = _mm_xor_si128(s2, t);
+			s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+			// Shifted down to 24 bits the value is positive, a signed conversion is exact
+			__m128 value = _mm_cvtepi32_ps(_mm_srli_epi32(result, 8));
+			_mm_storeu_ps(out + i, _mm_add_ps(offset, _mm_mul_ps(value, factor)));
+		}
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(m_Lanes[0].data()), s0);
+		_mm_store_si128(reinterpret_cast<__m128i*>(m_Lanes[1].data()), s1);
+		_mm_store_si128(reinterpret_cast<__m128i*>(m_Lanes[2].data()), s2);
+		_mm_store_si128(reinterpret_cast<__m128i*>(m_Lanes[3].data()), s3);
+#endif
+
+		// Whole steps of all four lanes, the last one may only use some of them
+		for (; i < count; i += 4)
+		{
+			for (size_t lane = 0; lane < 4; ++lane)
+			{
+				uint32_t& s0 = m_Lanes[0][lane];
+				uint32_t& s1 = m_Lanes[1][lane];
+				uint32_t& s2 = m_Lanes[2][lane];
+				uint32_t& s3 = m_Lanes[3][lane];
+
+				uint32_t result = s0 + s3;
+				uint32_t t = s1 << 9;
+
+				s2 ^= s0;
+				s3 ^= s1;
+				s1 ^= s2;
+				s0 ^= s3;
+				s2 ^= t;
+				s3 = RotateLeft(s3, 11);
+
+				if (i + lane < count) out[i + lane] = min + static_cast<float>(result >> 8) * scale;
+			}
+		}
+	}
+
+	RandomStreams::RandomStreams()
+	{
+		Seed(0);
+	}
+
+	void RandomStreams::Seed(uint64_t seed)
+	{
+		m_Seed = seed;
+
+		for (size_t i = 0; i < m_Streams.size(); ++i)
+			m_Streams[i].Seed(seed, i);
+	}
+
+	Random& RandomStreams::Get(size_t stream)
+	{
+		AF_ASSERT(stream < MaxStreams, "Random stream {} out of range, raise AF::RandomStreams::MaxStreams", stream);
+		return m_Streams[stream];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace AF
+{
+	// xoshiro128+ generator, small, fast and fully determined by its seed. Not thread safe, give every system or
+	// worker its own stream instead of sharing one.
+	class Random final
+	{
+	public:
+		Random(uint64_t seed = 0, uint64_t stream = 0);
+
+		// Generators with the same seed but different streams produce unrelated sequences
+		void Seed(uint64_t seed, uint64_t stream = 0);
+
+		uint32_t Next();
+
+		// Uniform in [min, max)
+		float Float(float min, float max);
+
+		// Uniform in [min, max]
+		int Int(int min, int max);
+
+		// Writes `count` floats uniform in [min, max) to `out`. Runs four interleaved generators side by side, with SSE2
+		// where available, the numbers are the same either way. Uses its own state, calling it doesn't change what
+		// Next returns.
+		void Fill(float* out, size_t count, float min, float max);
+	private:
+		std::array<uint32_t, 4> m_State;
+
+		// Word w of lane l at [w][l], the layout one SSE register per word wants
+		alignas(16) std::array<std::array<uint32_t, 4>, 4> m_Lanes;
+	};
+
+	// A scene's random streams, a scene resource. Streams are looked up by index and each system sticks to its own, so
+	// systems don't have to list this resource as access to run alongside each other.
+	class RandomStreams final
+	{
+	public:
+		static constexpr size_t MaxStreams = 16;
+
+		RandomStreams();
+
+		// Reseeds every stream, the same seed replays the same numbers
+		void Seed(uint64_t seed);
+
+		uint64_t GetSeed() const
+		{
+			return m_Seed;
+		}
+
+		Random& Get(size_t stream);
+	private:
+		uint64_t m_Seed = 0;
+		std::array<Random, MaxStreams> m_Streams;
+	};
+}
\ No newline at end of file
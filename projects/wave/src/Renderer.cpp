@@ -1,5 +1,7 @@
 #include "Renderer.h"
 
+#ifndef AF_HEADLESS
+
 namespace AF
 {
 	void Renderer::BeginFrame(glm::vec2 size)
@@ -47,6 +49,16 @@ namespace AF
 		nvgTextAlign(m_Vg, align);
 	}
 
+	void Renderer::Text(glm::vec2 position, const char* text)
+	{
+		nvgText(m_Vg, position.x, position.y, text, nullptr);
+	}
+
+	void Renderer::TextBox(glm::vec2 position, float width, const char* text)
+	{
+		nvgTextBox(m_Vg, position.x, position.y, width, text, nullptr);
+	}
+
 	//
 	//
 	//
@@ -58,4 +70,18 @@ namespace AF
 		FillColor(color);
 		Fill();
 	}
-}
\ No newline at end of file
+
+	void Renderer::FillRects(const glm::vec2* positions, const glm::vec2* sizes, const glm::vec4* colors, size_t count)
+	{
+		// nanovg takes one paint per fill, so rects of different colors can't share a path
+		for (size_t i = 0; i < count; ++i)
+		{
+			nvgBeginPath(m_Vg);
+			nvgRect(m_Vg, positions[i].x, positions[i].y, sizes[i].x, sizes[i].y);
+			nvgFillColor(m_Vg, *(NVGcolor*) &colors[i]);
+			nvgFill(m_Vg);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
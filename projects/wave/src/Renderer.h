@@ -18,9 +18,15 @@ namespace AF
 		void FontFace(const char* face);
 		void FontSize(float size);
 		void TextAlign(int align);
+		void Text(glm::vec2 position, const char* text);
+		void TextBox(glm::vec2 position, float width, const char* text);
 
 		void VGRP_FillRect(glm::vec2 position, glm::vec2 size, glm::vec4 color);
+
+		// Fills `count` rects in one call, the arrays are read in parallel
+		void FillRects(const glm::vec2* positions, const glm::vec2* sizes, const glm::vec4* colors, size_t count);
 		
-		NVGcontext* m_Vg;
+		// Null in headless builds, where every call is a no-op, see NullRenderer.cpp
+		NVGcontext* m_Vg = nullptr;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+
+namespace AF::ECS
+{
+	bool Scheduler::Conflicts(const System& a, const System& b)
+	{
+		return (a.m_Writes & (b.m_Reads | b.m_Writes)).any() || (b.m_Writes & a.m_Reads).any();
+	}
+
+	void Scheduler::AddSystem(System system)
+	{
+		// Nothing may be scheduled alongside or before an exclusive system that was added earlier
+		size_t stage = m_FirstFreeStage;
+
+		for (const System& other : m_Systems)
+		{
+			if (Conflicts(other, system))
+				stage = std::max(stage, other.m_Stage + 1);
+		}
+
+		if (system.m_Flags & System::EXCLUSIVE)
+		{
+			stage = std::max(stage, m_StageCount);
+			m_FirstFreeStage = stage + 1;
+		}
+
+		system.m_Stage = stage;
+		m_StageCount = std::max(m_StageCount, stage + 1);
+		m_Systems.push_back(std::move(system));
+	}
+
+	void Scheduler::Run(Scene& scene, JobSystem& jobs)
+	{
+		for (size_t stage = 0; stage < m_StageCount; ++stage)
+		{
+			JobCounter counter;
+
+			for (System& system : m_Systems)
+			{
+				if (system.m_Stage != stage || (system.m_Flags & System::EXCLUSIVE)) continue;
+
+				jobs.Submit([&system, &scene]() { system.m_Function(scene, *system.m_Commands); }, counter);
+			}
+
+			for (System& system : m_Systems)
+			{
+				if (system.m_Stage != stage || !(system.m_Flags & System::EXCLUSIVE)) continue;
+
+				system.m_Function(scene, *system.m_Commands);
+			}
+
+			jobs.Wait(counter);
+
+			for (System& system : m_Systems)
+			{
+				if (system.m_Stage == stage && !system.m_Commands->Empty())
+					system.m_Commands->Playback(scene);
+			}
+		}
+	}
+}
\ No newline at end of file
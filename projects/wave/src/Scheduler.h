@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <memory>
+#include <cstdint>
+
+#include "ECS.h"
+#include "CommandBuffer.h"
+#include "JobSystem.h"
+
+namespace AF::ECS
+{
+	// Access declarations used when adding a system, eg `Add<Read<RigidBody>, Write<Transform>>(...)`.
+	// Scene resources may be listed the same way, any type only orders the systems that name it.
+	template<typename... t_Types>
+	struct Read {};
+
+	template<typename... t_Types>
+	struct Write {};
+
+	struct System
+	{
+		enum Flags : uint8_t
+		{
+			NONE = 0,
+			EXCLUSIVE = 1 << 0 // Makes structural changes directly on the scene, runs alone on the calling thread between two barriers
+		};
+
+		const char* m_Name;
+		Signature m_Reads;
+		Signature m_Writes;
+		uint8_t m_Flags;
+		std::function<void(Scene&, CommandBuffer&)> m_Function;
+		size_t m_Stage = 0;
+
+		// Structural changes recorded by the system, played back once its stage is done
+		std::unique_ptr<CommandBuffer> m_Commands = std::make_unique<CommandBuffer>();
+	};
+
+	namespace Detail
+	{
+		template<typename t_Access>
+		struct AccessTraits;
+
+		template<typename... t_Types>
+		struct AccessTraits<Read<t_Types...>>
+		{
+			static Signature Reads() { return MakeSignature<t_Types...>(); }
+			static Signature Writes() { return {}; }
+		};
+
+		template<typename... t_Types>
+		struct AccessTraits<Write<t_Types...>>
+		{
+			static Signature Reads() { return {}; }
+			static Signature Writes() { return MakeSignature<t_Types...>(); }
+		};
+	}
+
+	// Groups systems into stages in the order they are added. A system lands in the first stage after every
+	// earlier system it conflicts with, two systems conflict when one writes a component the other reads or writes.
+	// Systems within a stage run concurrently, stages are separated by a barrier.
+	// A system is called as `function(Scene&)` or `function(Scene&, CommandBuffer&)`, the buffer belongs to the system.
+	// At the barrier every buffer of the stage is played back in the order the systems were added, so structural
+	// changes land the same way no matter which workers ran the systems.
+	class Scheduler final
+	{
+	public:
+		template<typename... t_Access, typename t_Function>
+		void Add(const char* name, t_Function&& function, uint8_t flags = System::NONE)
+		{
+			Signature reads = (Signature() | ... | Detail::AccessTraits<t_Access>::Reads());
+			Signature writes = (Signature() | ... | Detail::AccessTraits<t_Access>::Writes());
+
+			if constexpr (std::is_invocable_v<t_Function, Scene&, CommandBuffer&>)
+			{
+				AddSystem({ name, reads, writes, flags, std::forward<t_Function>(function) });
+			}
+			else
+			{
+				AddSystem({ name, reads, writes, flags, [function = std::forward<t_Function>(function)](Scene& scene, CommandBuffer&)
+				{
+					function(scene);
+				} });
+			}
+		}
+
+		void Run(Scene& scene, JobSystem& jobs);
+
+		const std::vector<System>& GetSystems() const
+		{
+			return m_Systems;
+		}
+
+		size_t GetStageCount() const
+		{
+			return m_StageCount;
+		}
+	private:
+		static bool Conflicts(const System& a, const System& b);
+
+		void AddSystem(System system);
+
+		std::vector<System> m_Systems;
+		size_t m_StageCount = 0;
+		size_t m_FirstFreeStage = 0;
+	};
+}
\ No newline at end of file
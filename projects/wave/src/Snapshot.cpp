@@ -0,0 +1,363 @@
+#include "Snapshot.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "Log.h"
+
+namespace AF::ECS
+{
+	static constexpr uint32_t s_SnapshotMagic = 0x53534641; // "AFSS"
+	static constexpr uint32_t s_SnapshotVersion = 2;
+
+	namespace
+	{
+		class Writer final
+		{
+		public:
+			Writer(std::vector<std::byte>& out)
+				: m_Out(out)
+			{
+			}
+
+			// Grows the output and returns the new region for the caller to fill
+			std::byte* Extend(size_t size)
+			{
+				size_t offset = m_Out.size();
+				m_Out.resize(offset + size);
+				return m_Out.data() + offset;
+			}
+
+			void Bytes(const void* data, size_t size)
+			{
+				if (size != 0) std::memcpy(Extend(size), data, size);
+			}
+
+			template<typename t_Type>
+			void Value(const t_Type& value)
+			{
+				Bytes(&value, sizeof(t_Type));
+			}
+		private:
+			std::vector<std::byte>& m_Out;
+		};
+
+		class Reader final
+		{
+		public:
+			Reader(const std::vector<std::byte>& data)
+				: m_Data(data)
+			{
+			}
+
+			// Returns the next `size` bytes, or nullptr when the data is too short
+			const std::byte* Consume(size_t size)
+			{
+				if (size > m_Data.size() - m_Position) return nullptr;
+
+				const std::byte* data = m_Data.data() + m_Position;
+				m_Position += size;
+				return data;
+			}
+
+			bool Bytes(void* destination, size_t size)
+			{
+				const std::byte* data = Consume(size);
+				if (!data) return false;
+
+				if (size != 0) std::memcpy(destination, data, size);
+				return true;
+			}
+
+			template<typename t_Type>
+			bool Value(t_Type& value)
+			{
+				return Bytes(&value, sizeof(t_Type));
+			}
+		private:
+			const std::vector<std::byte>& m_Data;
+			size_t m_Position = 0;
+		};
+
+		// Only generations and kill flags are stored, the archetype and row of live records are rebuilt from the archetypes
+		bool LoadRecords(Scene& scene, Reader& reader)
+		{
+			uint64_t recordCount, freeCount;
+			if (!reader.Value(recordCount) || recordCount > ~0u) return false;
+
+			const std::byte* generations = reader.Consume(recordCount * sizeof(uint32_t));
+			const std::byte* dead = reader.Consume(recordCount);
+			if (!generations || !dead) return false;
+
+			scene.m_Records.resize(recordCount);
+
+			for (uint32_t index = 0; index < recordCount; ++index)
+			{
+				EntityRecord& record = scene.m_Records[index];
+				std::memcpy(&record.m_Generation, generations + index * sizeof(uint32_t), sizeof(uint32_t));
+				record.m_Dead = dead[index] != std::byte(0);
+
+				// Kills are queued in index order, the same order FlushDestroyed sorts them into
+				if (record.m_Dead)
+					scene.m_PendingDestroy.push_back({ index, record.m_Generation });
+			}
+
+			if (!reader.Value(freeCount) || freeCount > recordCount) return false;
+
+			scene.m_FreeIndices.resize(freeCount);
+			return reader.Bytes(scene.m_FreeIndices.data(), freeCount * sizeof(uint32_t));
+		}
+
+		bool LoadArchetypes(Scene& scene, Reader& reader)
+		{
+			uint64_t archetypeCount;
+			if (!reader.Value(archetypeCount)) return false;
+
+			for (uint64_t i = 0; i < archetypeCount; ++i)
+			{
+				uint64_t columnCount;
+				if (!reader.Value(columnCount) || columnCount > MaxComponents) return false;
+
+				std::array<const ComponentInfo*, MaxComponents> infos;
+				Signature signature;
+
+				for (uint64_t column = 0; column < columnCount; ++column)
+				{
+					uint64_t typeHash, size;
+					if (!reader.Value(typeHash) || !reader.Value(size)) return false;
+
+					infos[column] = Detail::FindComponentInfoByHash(typeHash);
+
+					if (!infos[column] || infos[column]->m_Size != size || !infos[column]->m_TriviallyCopyable)
+					{
+						AF_ERROR("Snapshot contains an unknown component type");
+						return false;
+					}
+
+					signature.set(infos[column]->m_Id);
+				}
+
+				uint64_t rows;
+				if (!reader.Value(rows) || rows > scene.m_Records.size()) return false;
+
+				Archetype* archetype = scene.FindArchetype(signature);
+				if (archetype->Size() != 0) return false;
+
+				archetype->Reserve(rows);
+				archetype->m_Entities.resize(rows);
+
+				if (!reader.Bytes(archetype->m_Entities.data(), rows * sizeof(EntityId))) return false;
+
+				for (uint64_t column = 0; column < columnCount; ++column)
+				{
+					Column* target = archetype->FindColumn(infos[column]->m_Id);
+					if (!reader.Bytes(target->m_Data, rows * infos[column]->m_Size)) return false;
+
+					// Everything restored counts as changed
+					std::fill(target->m_Versions, target->m_Versions + rows, scene.m_ChangeTick);
+				}
+
+				for (uint32_t row = 0; row < rows; ++row)
+				{
+					EntityId id = archetype->m_Entities[row];
+					if (id.m_Index >= scene.m_Records.size()) return false;
+
+					EntityRecord& record = scene.m_Records[id.m_Index];
+					record.m_Archetype = archetype;
+					record.m_Row = row;
+				}
+
+				scene.m_EntityCount += rows;
+				scene.m_EntitiesCreated += rows;
+			}
+
+			return true;
+		}
+
+		// Tag lists are stored as is so iteration order survives the round trip
+		bool LoadTags(Scene& scene, Reader& reader)
+		{
+			uint64_t tagCount;
+			if (!reader.Value(tagCount) || tagCount > 256) return false;
+
+			scene.m_Tagged.resize(std::max<size_t>(scene.m_Tagged.size(), tagCount));
+
+			for (uint64_t tag = 0; tag < tagCount; ++tag)
+			{
+				uint64_t count;
+				if (!reader.Value(count) || count > scene.m_Records.size()) return false;
+
+				std::vector<EntityId>& tagged = scene.m_Tagged[tag];
+				tagged.resize(count);
+				if (!reader.Bytes(tagged.data(), count * sizeof(EntityId))) return false;
+
+				for (uint32_t slot = 0; slot < count; ++slot)
+				{
+					if (tagged[slot].m_Index >= scene.m_Records.size()) return false;
+
+					EntityRecord& record = scene.m_Records[tagged[slot].m_Index];
+					record.m_Tag = static_cast<Tag>(tag);
+					record.m_TagSlot = slot;
+				}
+			}
+
+			return true;
+		}
+
+		bool LoadPendingStarts(Scene& scene, Reader& reader)
+		{
+			uint64_t startCount;
+			if (!reader.Value(startCount)) return false;
+
+			for (uint64_t i = 0; i < startCount; ++i)
+			{
+				EntityId entity;
+				uint64_t typeHash;
+				if (!reader.Value(entity) || !reader.Value(typeHash)) return false;
+
+				const ComponentInfo* info = Detail::FindComponentInfoByHash(typeHash);
+				if (!info) return false;
+
+				scene.m_PendingStarts.push_back({ entity, info->m_Id });
+			}
+
+			return true;
+		}
+	}
+
+	bool SaveSnapshot(Scene& scene, std::vector<std::byte>& out)
+	{
+		out.clear();
+
+		size_t dataSize = 0;
+		uint64_t archetypeCount = 0;
+
+		for (auto& archetype : scene.m_Archetypes)
+		{
+			if (archetype->Size() == 0) continue;
+
+			for (Column& column : archetype->m_Columns)
+			{
+				if (!column.m_Info->m_TriviallyCopyable)
+				{
+					AF_ERROR("Snapshots only support trivially copyable components");
+					return false;
+				}
+
+				dataSize += archetype->Size() * column.m_Info->m_Size;
+			}
+
+			++archetypeCount;
+		}
+
+		size_t recordCount = scene.m_Records.size();
+
+		// Reserving the payload up front keeps the bulk copies from reallocating
+		out.reserve(dataSize + scene.m_EntityCount * sizeof(EntityId) + recordCount * (sizeof(uint32_t) * 2 + 1) + 1024);
+
+		Writer writer(out);
+		writer.Value(s_SnapshotMagic);
+		writer.Value(s_SnapshotVersion);
+		writer.Value(scene.m_GenerationBase);
+		writer.Value(scene.m_NextGeneration);
+
+		writer.Value<uint64_t>(recordCount);
+
+		std::byte* generations = writer.Extend(recordCount * sizeof(uint32_t) + recordCount);
+		std::byte* dead = generations + recordCount * sizeof(uint32_t);
+
+		for (size_t index = 0; index < recordCount; ++index)
+		{
+			const EntityRecord& record = scene.m_Records[index];
+			std::memcpy(generations + index * sizeof(uint32_t), &record.m_Generation, sizeof(uint32_t));
+			dead[index] = std::byte(record.m_Dead);
+		}
+
+		writer.Value<uint64_t>(scene.m_FreeIndices.size());
+		writer.Bytes(scene.m_FreeIndices.data(), scene.m_FreeIndices.size() * sizeof(uint32_t));
+
+		writer.Value(archetypeCount);
+
+		for (auto& archetype : scene.m_Archetypes)
+		{
+			if (archetype->Size() == 0) continue;
+
+			writer.Value<uint64_t>(archetype->m_Columns.size());
+
+			for (Column& column : archetype->m_Columns)
+			{
+				writer.Value(column.m_Info->m_TypeHash);
+				writer.Value<uint64_t>(column.m_Info->m_Size);
+			}
+
+			writer.Value<uint64_t>(archetype->Size());
+			writer.Bytes(archetype->m_Entities.data(), archetype->Size() * sizeof(EntityId));
+
+			for (Column& column : archetype->m_Columns)
+				writer.Bytes(column.m_Data, archetype->Size() * column.m_Info->m_Size);
+		}
+
+		writer.Value<uint64_t>(scene.m_Tagged.size());
+
+		for (const std::vector<EntityId>& tagged : scene.m_Tagged)
+		{
+			writer.Value<uint64_t>(tagged.size());
+			writer.Bytes(tagged.data(), tagged.size() * sizeof(EntityId));
+		}
+
+		writer.Value<uint64_t>(scene.m_PendingStarts.size());
+
+		for (const Scene::PendingStart& pending : scene.m_PendingStarts)
+		{
+			writer.Value(pending.m_Entity);
+			writer.Value(Detail::FindComponentInfo(pending.m_Component)->m_TypeHash);
+		}
+
+		return true;
+	}
+
+	bool LoadSnapshot(Scene& scene, const std::vector<std::byte>& data)
+	{
+		scene.Clear();
+
+		Reader reader(data);
+
+		uint32_t magic, version;
+		if (!reader.Value(magic) || !reader.Value(version) || magic != s_SnapshotMagic || version != s_SnapshotVersion)
+		{
+			AF_ERROR("Invalid scene snapshot");
+			return false;
+		}
+
+		uint32_t nextGeneration = scene.m_NextGeneration;
+
+		bool loaded = reader.Value(scene.m_GenerationBase) && reader.Value(scene.m_NextGeneration)
+			&& LoadRecords(scene, reader)
+			&& LoadArchetypes(scene, reader)
+			&& LoadTags(scene, reader)
+			&& LoadPendingStarts(scene, reader);
+
+		if (!loaded)
+		{
+			AF_ERROR("Scene snapshot is truncated or corrupt");
+
+			// Clearing again raises the base generation past anything handed out before the load
+			scene.m_NextGeneration = std::max(scene.m_NextGeneration, nextGeneration);
+			scene.Clear();
+			return false;
+		}
+
+		// Live records keep their generation so handles from the checkpoint resolve again. Everything else starts past
+		// the generations given out before the load, otherwise handles taken after the checkpoint would come back to life
+		// on a different entity once their index is reused.
+		scene.m_GenerationBase = std::max(scene.m_NextGeneration, nextGeneration);
+		scene.m_NextGeneration = scene.m_GenerationBase;
+
+		for (EntityRecord& record : scene.m_Records)
+		{
+			if (!record.m_Archetype) record.m_Generation = scene.m_GenerationBase;
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "ECS.h"
+
+namespace AF::ECS
+{
+	// Captures every entity with its components and tag, plus the pending kills and starts of a scene, into a compact binary blob.
+	// Column storage is copied as is, so only trivially copyable components are supported and a snapshot
+	// can only be restored by the same build. Returns false and leaves `out` empty if the scene can't be captured.
+	bool SaveSnapshot(Scene& scene, std::vector<std::byte>& out);
+
+	// Replaces the contents of the scene with a snapshot, handles that were valid when it was taken are valid again.
+	// Handles given out since then stay invalid, even once their index is reused. On failure the scene is left empty.
+	bool LoadSnapshot(Scene& scene, const std::vector<std::byte>& data);
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Log.h"
+
+namespace AF
+{
+	void SpatialGrid::Reset(glm::vec2 worldSize, float cellSize)
+	{
+		m_WorldSize = worldSize;
+		m_CellSize = cellSize;
+		m_Columns = std::max(1, static_cast<int>(std::ceil(worldSize.x / cellSize)));
+		m_Rows = std::max(1, static_cast<int>(std::ceil(worldSize.y / cellSize)));
+
+		m_Cells.resize(static_cast<size_t>(m_Columns) * m_Rows);
+		Clear();
+	}
+
+	void SpatialGrid::Clear()
+	{
+		for (std::vector<uint32_t>& cell : m_Cells)
+			cell.clear();
+
+		m_Items.clear();
+		m_Lookup.clear();
+	}
+
+	SpatialGrid::CellRange SpatialGrid::ToCells(glm::vec2 min, glm::vec2 max) const
+	{
+		auto toCell = [this](float position, int count)
+		{
+			return std::clamp(static_cast<int>(std::floor(position / m_CellSize)), 0, count - 1);
+		};
+
+		return { toCell(min.x, m_Columns), toCell(min.y, m_Rows), toCell(max.x, m_Columns), toCell(max.y, m_Rows) };
+	}
+
+	void SpatialGrid::Link(uint32_t index)
+	{
+		const CellRange& range = m_Items[index].m_Cells;
+
+		for (int y = range.m_MinY; y <= range.m_MaxY; ++y)
+		{
+			for (int x = range.m_MinX; x <= range.m_MaxX; ++x)
+				m_Cells[y * m_Columns + x].push_back(index);
+		}
+	}
+
+	void SpatialGrid::Unlink(uint32_t index)
+	{
+		const CellRange& range = m_Items[index].m_Cells;
+
+		for (int y = range.m_MinY; y <= range.m_MaxY; ++y)
+		{
+			for (int x = range.m_MinX; x <= range.m_MaxX; ++x)
+			{
+				std::vector<uint32_t>& cell = m_Cells[y * m_Columns + x];
+
+				auto it = std::find(cell.begin(), cell.end(), index);
+				*it = cell.back();
+				cell.pop_back();
+			}
+		}
+	}
+
+	void SpatialGrid::Relink(uint32_t from, uint32_t to)
+	{
+		const CellRange& range = m_Items[from].m_Cells;
+
+		for (int y = range.m_MinY; y <= range.m_MaxY; ++y)
+		{
+			for (int x = range.m_MinX; x <= range.m_MaxX; ++x)
+			{
+				std::vector<uint32_t>& cell = m_Cells[y * m_Columns + x];
+				*std::find(cell.begin(), cell.end(), from) = to;
+			}
+		}
+	}
+
+	void SpatialGrid::Set(ECS::EntityId id, glm::vec2 min, glm::vec2 max)
+	{
+		AF_ASSERT(!m_Cells.empty(), "SpatialGrid::Reset must be called before adding entities");
+
+		CellRange cells = ToCells(min, max);
+
+		if (id.m_Index >= m_Lookup.size())
+			m_Lookup.resize(id.m_Index + 1, ~0u);
+
+		uint32_t index = m_Lookup[id.m_Index];
+
+		if (index == ~0u)
+		{
+			index = static_cast<uint32_t>(m_Items.size());
+			m_Items.push_back({ id, min, max, cells });
+			m_Lookup[id.m_Index] = index;
+			Link(index);
+			return;
+		}
+
+		Item& item = m_Items[index];
+		item.m_Id = id;
+		item.m_Min = min;
+		item.m_Max = max;
+
+		if (item.m_Cells == cells) return;
+
+		Unlink(index);
+		item.m_Cells = cells;
+		Link(index);
+	}
+
+	void SpatialGrid::Remove(ECS::EntityId id)
+	{
+		if (id.m_Index >= m_Lookup.size()) return;
+
+		uint32_t index = m_Lookup[id.m_Index];
+		if (index != ~0u && m_Items[index].m_Id == id) RemoveItem(index);
+	}
+
+	void SpatialGrid::RemoveItem(uint32_t index)
+	{
+		Unlink(index);
+		m_Lookup[m_Items[index].m_Id.m_Index] = ~0u;
+
+		uint32_t last = static_cast<uint32_t>(m_Items.size() - 1);
+
+		if (index != last)
+		{
+			Relink(last, index);
+			m_Items[index] = m_Items[last];
+			m_Lookup[m_Items[index].m_Id.m_Index] = index;
+		}
+
+		m_Items.pop_back();
+	}
+
+	void SpatialGrid::QueryAABB(glm::vec2 min, glm::vec2 max, std::vector<ECS::EntityId>& out) const
+	{
+		if (m_Cells.empty()) return;
+
+		Visit(ToCells(min, max), [min, max, &out](const Item& item)
+		{
+			if (item.m_Min.x < max.x && min.x < item.m_Max.x && item.m_Min.y < max.y && min.y < item.m_Max.y)
+				out.push_back(item.m_Id);
+		});
+	}
+
+	void SpatialGrid::QueryRadius(glm::vec2 center, float radius, std::vector<ECS::EntityId>& out) const
+	{
+		if (m_Cells.empty()) return;
+
+		Visit(ToCells(center - radius, center + radius), [center, radius, &out](const Item& item)
+		{
+			glm::vec2 closest = glm::clamp(center, item.m_Min, item.m_Max);
+			glm::vec2 offset = closest - center;
+
+			if (glm::dot(offset, offset) < radius * radius)
+				out.push_back(item.m_Id);
+		});
+	}
+}
\ No newline at end of file
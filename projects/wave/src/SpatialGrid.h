@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "ECS.h"
+
+namespace AF
+{
+	// Uniform grid of square cells over a fixed area, each entry is an entity with an axis aligned box.
+	// An entry is linked into every cell its box touches, moving it only relinks when that set of cells changes.
+	// Boxes outside the area are clamped into the border cells. Queries are safe to run concurrently with each other
+	// but not with Set or Remove.
+	class SpatialGrid final
+	{
+	public:
+		// Drops every entry and lays out cells of `cellSize` over [0, worldSize]
+		void Reset(glm::vec2 worldSize, float cellSize);
+
+		// Drops every entry, the cell layout is kept
+		void Clear();
+
+		glm::vec2 GetWorldSize() const
+		{
+			return m_WorldSize;
+		}
+
+		size_t Size() const
+		{
+			return m_Items.size();
+		}
+
+		// Inserts the entity or moves it to the new box, a reused entity index replaces the previous entry
+		void Set(ECS::EntityId id, glm::vec2 min, glm::vec2 max);
+		void Remove(ECS::EntityId id);
+
+		template<typename t_Predicate>
+		void RemoveIf(t_Predicate&& predicate)
+		{
+			for (size_t i = m_Items.size(); i-- > 0;)
+			{
+				if (predicate(m_Items[i].m_Id)) RemoveItem(static_cast<uint32_t>(i));
+			}
+		}
+
+		// Append every entity whose box overlaps the area to `out`, each entity at most once
+		void QueryAABB(glm::vec2 min, glm::vec2 max, std::vector<ECS::EntityId>& out) const;
+		void QueryRadius(glm::vec2 center, float radius, std::vector<ECS::EntityId>& out) const;
+	private:
+		struct CellRange
+		{
+			int m_MinX, m_MinY;
+			int m_MaxX, m_MaxY;
+
+			bool operator==(const CellRange& other) const
+			{
+				return m_MinX == other.m_MinX && m_MinY == other.m_MinY && m_MaxX == other.m_MaxX && m_MaxY == other.m_MaxY;
+			}
+		};
+
+		struct Item
+		{
+			ECS::EntityId m_Id;
+			glm::vec2 m_Min;
+			glm::vec2 m_Max;
+			CellRange m_Cells;
+		};
+
+		CellRange ToCells(glm::vec2 min, glm::vec2 max) const;
+
+		// Calls `function(const Item&)` once for every entry linked into `range`
+		template<typename t_Function>
+		void Visit(const CellRange& range, t_Function&& function) const
+		{
+			for (int y = range.m_MinY; y <= range.m_MaxY; ++y)
+			{
+				for (int x = range.m_MinX; x <= range.m_MaxX; ++x)
+				{
+					for (uint32_t index : m_Cells[y * m_Columns + x])
+					{
+						const Item& item = m_Items[index];
+
+						// An entry spanning several cells is only reported from the first one the query shares with it
+						if (x != std::max(item.m_Cells.m_MinX, range.m_MinX) || y != std::max(item.m_Cells.m_MinY, range.m_MinY)) continue;
+
+						function(item);
+					}
+				}
+			}
+		}
+
+		void Link(uint32_t index);
+		void Unlink(uint32_t index);
+		void Relink(uint32_t from, uint32_t to);
+		void RemoveItem(uint32_t index);
+
+		glm::vec2 m_WorldSize = { 0.0f, 0.0f };
+		float m_CellSize = 1.0f;
+		int m_Columns = 0;
+		int m_Rows = 0;
+
+		// Indices into m_Items, one list per cell in row major order
+		std::vector<std::vector<uint32_t>> m_Cells;
+		std::vector<Item> m_Items;
+
+		// Entity index to its position in m_Items, ~0u for entities that aren't in the grid
+		std::vector<uint32_t> m_Lookup;
+	};
+}
\ No newline at end of file
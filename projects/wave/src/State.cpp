@@ -1,5 +1,14 @@
 #include "State.h"
 
+#if defined(AF_PLAT_WINDOWS)
+	#define NOMINMAX
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#elif defined(AF_PLAT_LINUX)
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
 namespace AF
 {
 	StateManager* State::GetStateManager()
@@ -7,6 +16,48 @@ namespace AF
 		return m_StateManager;
 	}
 
+	StateManager::StateManager()
+		: m_ReclaimThread([this]() { ReclaimMain(); })
+	{
+	}
+
+	StateManager::~StateManager()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_ReclaimMutex);
+			m_Stopping = true;
+		}
+
+		m_ReclaimCondition.notify_one();
+		m_ReclaimThread.join();
+	}
+
+	void StateManager::ReclaimMain()
+	{
+#if defined(AF_PLAT_WINDOWS)
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(AF_PLAT_LINUX)
+		sched_param param = {};
+		pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+
+		std::vector<std::shared_ptr<State>> retired;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_ReclaimMutex);
+				m_ReclaimCondition.wait(lock, [this]() { return m_Stopping || !m_Retired.empty(); });
+
+				if (m_Retired.empty()) return;
+				retired.swap(m_Retired);
+			}
+
+			// Anything still sharing a state keeps it alive, the last owner destroys it wherever that is
+			retired.clear();
+		}
+	}
+
 	std::shared_ptr<State> StateManager::GetState()
 	{
 		return m_State;
@@ -18,9 +69,16 @@ namespace AF
 		{
 			m_State->Detach();
 			m_State->m_StateManager = nullptr;
+
+			{
+				std::lock_guard<std::mutex> lock(m_ReclaimMutex);
+				m_Retired.push_back(std::move(m_State));
+			}
+
+			m_ReclaimCondition.notify_one();
 		}
 
-		m_State = state;
+		m_State = std::move(state);
 
 		if (m_State)
 		{
@@ -29,6 +87,11 @@ namespace AF
 		}
 	}
 
+	void StateManager::FixedUpdate()
+	{
+		if (m_State) m_State->FixedUpdate();
+	}
+
 	void StateManager::Update()
 	{
 		if (m_State) m_State->Update();
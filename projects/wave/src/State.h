@@ -1,6 +1,10 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace AF
 {
@@ -12,6 +16,10 @@ namespace AF
 	public:
 		StateManager* GetStateManager();
 
+		// Called once per simulation tick, see Application::m_FixedDeltaTime
+		virtual void FixedUpdate() = 0;
+
+		// Called once per rendered frame
 		virtual void Update() = 0;
 	private:
 		virtual void Attach() = 0;
@@ -20,14 +28,33 @@ namespace AF
 		StateManager* m_StateManager = nullptr;
 	};
 
+	// Replaced states are detached on the calling thread, then handed to a low priority thread that drops them.
+	// Tearing down a finished scene can take a while, this keeps it out of the frame the transition happens on.
+	// States must therefore not touch anything owned by the game thread from their destructor, cleanup of that kind
+	// belongs in Detach.
 	class StateManager final
 	{
 	public:
+		StateManager();
+		StateManager(const StateManager&) = delete;
+		~StateManager();
+
+		StateManager& operator=(const StateManager&) = delete;
+
 		std::shared_ptr<State> GetState();
 		void SetState(std::shared_ptr<State> state);
 
+		void FixedUpdate();
 		void Update();
 	private:
+		void ReclaimMain();
+
 		std::shared_ptr<State> m_State = nullptr;
+
+		std::vector<std::shared_ptr<State>> m_Retired;
+		std::mutex m_ReclaimMutex;
+		std::condition_variable m_ReclaimCondition;
+		bool m_Stopping = false;
+		std::thread m_ReclaimThread;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "SweepAndPrune.h"
+
+namespace AF
+{
+	void SweepAndPrune::Set(ECS::EntityId id, glm::vec2 min, glm::vec2 max)
+	{
+		if (id.m_Index >= m_Lookup.size())
+			m_Lookup.resize(id.m_Index + 1, ~0u);
+
+		uint32_t index = m_Lookup[id.m_Index];
+
+		if (index == ~0u)
+		{
+			m_Lookup[id.m_Index] = static_cast<uint32_t>(m_Items.size());
+			m_Items.push_back({ id, min, max });
+			return;
+		}
+
+		m_Items[index] = { id, min, max };
+	}
+
+	void SweepAndPrune::Clear()
+	{
+		m_Items.clear();
+		m_Lookup.clear();
+	}
+
+	void SweepAndPrune::Sort()
+	{
+		// Insertion sort, each entry only moves past the ones it overtook since the last call
+		for (size_t i = 1; i < m_Items.size(); ++i)
+		{
+			if (!(m_Items[i].m_Min.x < m_Items[i - 1].m_Min.x)) continue;
+
+			Item item = m_Items[i];
+			size_t j = i;
+
+			for (; j > 0 && item.m_Min.x < m_Items[j - 1].m_Min.x; --j)
+			{
+				m_Items[j] = m_Items[j - 1];
+				m_Lookup[m_Items[j].m_Id.m_Index] = static_cast<uint32_t>(j);
+			}
+
+			m_Items[j] = item;
+			m_Lookup[item.m_Id.m_Index] = static_cast<uint32_t>(j);
+		}
+	}
+
+	void SweepAndPrune::FindOverlaps(std::vector<Pair>& out)
+	{
+		Sort();
+
+		size_t count = m_Items.size();
+
+		// The sweep only reads the bounds, packed tightly they stream through the cache
+		m_MinX.resize(count);
+		m_MaxX.resize(count);
+		m_MinY.resize(count);
+		m_MaxY.resize(count);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			m_MinX[i] = m_Items[i].m_Min.x;
+			m_MaxX[i] = m_Items[i].m_Max.x;
+			m_MinY[i] = m_Items[i].m_Min.y;
+			m_MaxY[i] = m_Items[i].m_Max.y;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			float maxX = m_MaxX[i], minY = m_MinY[i], maxY = m_MaxY[i];
+
+			// Everything after `i` that starts before it ends overlaps it on x
+			size_t end = i + 1;
+			while (end < count && m_MinX[end] < maxX) ++end;
+
+			// Few of those overlap on y as well, so the test is kept free of branches and the hits are compacted
+			m_Hits.resize(end - i);
+			size_t hits = 0;
+
+			for (size_t j = i + 1; j < end; ++j)
+			{
+				m_Hits[hits] = static_cast<uint32_t>(j);
+				hits += (m_MinY[j] < maxY) & (minY < m_MaxY[j]);
+			}
+
+			for (size_t k = 0; k < hits; ++k)
+				out.push_back({ m_Items[i].m_Id, m_Items[m_Hits[k]].m_Id });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "ECS.h"
+
+namespace AF
+{
+	// Broad phase that finds overlapping boxes by sorting them along x and sweeping over the sorted list.
+	// The order is kept between calls, boxes only move a little each tick so re-sorting it is an insertion sort over
+	// nearly sorted data and close to linear.
+	class SweepAndPrune final
+	{
+	public:
+		using Pair = std::pair<ECS::EntityId, ECS::EntityId>;
+
+		size_t Size() const
+		{
+			return m_Items.size();
+		}
+
+		// Inserts the entity or moves it to the new box, a reused entity index replaces the previous entry
+		void Set(ECS::EntityId id, glm::vec2 min, glm::vec2 max);
+		void Clear();
+
+		// Drops every entry the predicate returns true for, keeping the others in order
+		template<typename t_Predicate>
+		void RemoveIf(t_Predicate&& predicate)
+		{
+			size_t count = 0;
+
+			for (size_t i = 0; i < m_Items.size(); ++i)
+			{
+				if (predicate(m_Items[i].m_Id))
+				{
+					m_Lookup[m_Items[i].m_Id.m_Index] = ~0u;
+					continue;
+				}
+
+				m_Items[count] = m_Items[i];
+				m_Lookup[m_Items[count].m_Id.m_Index] = static_cast<uint32_t>(count);
+				++count;
+			}
+
+			m_Items.resize(count);
+		}
+
+		// Appends every pair of overlapping boxes to `out` once, in a deterministic order. Touching edges don't count.
+		void FindOverlaps(std::vector<Pair>& out);
+	private:
+		struct Item
+		{
+			ECS::EntityId m_Id;
+			glm::vec2 m_Min;
+			glm::vec2 m_Max;
+		};
+
+		void Sort();
+
+		// Sorted by m_Min.x as of the last FindOverlaps, new entries are appended
+		std::vector<Item> m_Items;
+
+		// Bounds of m_Items in sorted order, rebuilt for every sweep
+		std::vector<float> m_MinX;
+		std::vector<float> m_MaxX;
+		std::vector<float> m_MinY;
+		std::vector<float> m_MaxY;
+		std::vector<uint32_t> m_Hits;
+
+		// Entity index to its position in m_Items, ~0u for entities that aren't tracked
+		std::vector<uint32_t> m_Lookup;
+	};
+}
\ No newline at end of file
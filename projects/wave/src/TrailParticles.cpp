@@ -0,0 +1,65 @@
+#include "TrailParticles.h"
+
+#include <algorithm>
+
+#include "Renderer.h"
+#include "Log.h"
+
+namespace AF
+{
+	TrailParticles::TrailParticles(size_t capacity, float lifetime)
+		: m_Positions(capacity), m_Sizes(capacity), m_Colors(capacity), m_Ages(capacity), m_Lifetime(lifetime)
+	{
+		AF_ASSERT(capacity != 0, "TrailParticles needs room for at least one particle");
+	}
+
+	void TrailParticles::Emit(glm::vec2 position, glm::vec2 size, glm::vec4 color)
+	{
+		size_t index = (m_Head + m_Count) % Capacity();
+
+		if (m_Count == Capacity())
+			m_Head = (m_Head + 1) % Capacity();
+		else
+			++m_Count;
+
+		m_Positions[index] = position;
+		m_Sizes[index] = size;
+		m_Colors[index] = color;
+		m_Ages[index] = 0.0f;
+	}
+
+	void TrailParticles::Update(float deltaTime)
+	{
+		float inverseLifetime = 1.0f / m_Lifetime;
+
+		ForEachSpan([this, deltaTime, inverseLifetime](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				m_Ages[i] += deltaTime;
+				m_Colors[i].a = 1.0f - std::min(m_Ages[i] * inverseLifetime, 1.0f);
+			}
+		});
+
+		// Ages only ever decrease from the head on
+		while (m_Count != 0 && m_Ages[m_Head] >= m_Lifetime)
+		{
+			m_Head = (m_Head + 1) % Capacity();
+			--m_Count;
+		}
+	}
+
+	void TrailParticles::Clear()
+	{
+		m_Head = 0;
+		m_Count = 0;
+	}
+
+	void TrailParticles::Draw(Renderer& renderer) const
+	{
+		ForEachSpan([this, &renderer](size_t begin, size_t end)
+		{
+			renderer.FillRects(&m_Positions[begin], &m_Sizes[begin], &m_Colors[begin], end - begin);
+		});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+namespace AF
+{
+	class Renderer;
+
+	// Fading boxes left behind moving entities, kept out of the ECS as a fixed size ring buffer with one array per
+	// field. Every particle lives equally long and they are emitted in order, so the oldest ones are always at the
+	// head and expiring is just moving it. Once full, emitting replaces the oldest particle, memory never grows past
+	// the capacity no matter how many spawners there are.
+	class TrailParticles final
+	{
+	public:
+		TrailParticles(size_t capacity = 8192, float lifetime = 0.2f);
+
+		size_t Size() const
+		{
+			return m_Count;
+		}
+
+		size_t Capacity() const
+		{
+			return m_Ages.size();
+		}
+
+		void Emit(glm::vec2 position, glm::vec2 size, glm::vec4 color);
+
+		// Ages every particle, fades it out over its lifetime and drops the ones that are done
+		void Update(float deltaTime);
+		void Clear();
+
+		// Must be called inside a renderer frame
+		void Draw(Renderer& renderer) const;
+	private:
+		// Calls `function(begin, end)` for the one or two index ranges the live particles occupy, oldest first
+		template<typename t_Function>
+		void ForEachSpan(t_Function&& function) const
+		{
+			size_t end = m_Head + m_Count;
+
+			if (end <= Capacity())
+			{
+				function(m_Head, end);
+			}
+			else
+			{
+				function(m_Head, Capacity());
+				function(size_t(0), end - Capacity());
+			}
+		}
+
+		std::vector<glm::vec2> m_Positions;
+		std::vector<glm::vec2> m_Sizes;
+		std::vector<glm::vec4> m_Colors;
+		std::vector<float> m_Ages;
+
+		float m_Lifetime;
+
+		// Index of the oldest particle
+		size_t m_Head = 0;
+		size_t m_Count = 0;
+	};
+}
\ No newline at end of file